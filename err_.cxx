@@ -1,5 +1,182 @@
 #include "err_.H"
 
+QString formatBytes(qulonglong bytes) {
+    double b = bytes;
+    const char *units[] = {"B","KB","MB","GB","TB"};
+    int i = 0;
+    while (b >= 1024.0 && i < 4) { b /= 1024.0; ++i; }
+    return QString::number(b, 'f', (i == 0 ? 0 : 1)) + " " + units[i];
+}
+
+namespace Theme {
+// The whole application is styled from this one sheet, parsed once in main().
+// Widgets opt in through the "class" property instead of carrying their own
+// sheets, and transient looks are driven by properties through setState().
+QString styleSheet() {
+    return QStringLiteral(R"(
+* {
+    font-family: 'Nimbus Mono', 'Monospace';
+    color: #dfe2ec;
+}
+
+QDialog {
+    border: 1px solid #1a3cff;
+    border-radius: 8px;
+}
+
+QMessageBox QPushButton {
+    background-color: #112266;
+    color: white;
+    border: none;
+    padding: 8px 16px;
+    border-radius: 5px;
+    font-weight: bold;
+    font-size: 12px;
+    min-width: 80px;
+}
+QMessageBox QPushButton:hover {
+    background-color: #1a3cff;
+}
+
+QLabel[class="titleText"], QPushButton[class="titleText"] {
+    font-size: 32px;
+    font-weight: bold;
+    color: #dfe2ec;
+    border: none;
+}
+
+QLabel[class="smallText"], QPushButton[class="smallText"] {
+    font-size: 13px;
+    color: #cccccc;
+    border: none;
+}
+
+QPushButton[class="plainButton"] {
+    background-color: #112266;
+    color: white;
+    border: none;
+    padding: 10px 16px;
+    border-radius: 5px;
+    font-weight: bold;
+    font-size: 12px;
+}
+QPushButton[class="plainButton"]:hover {
+    background-color: #1a3cff;
+}
+
+QLineEdit, QTextEdit, QComboBox, QListWidget {
+    background-color: #111;
+    color: white;
+    border: 1px solid #223355;
+    padding: 5px;
+    border-radius: 4px;
+}
+
+QGroupBox {
+    color: #ffffff;
+    font-weight: bold;
+    font-size: 13px;
+    margin-top: 12px;
+    padding-top: 12px;
+    border: 1px solid #1a3cff;
+    border-radius: 6px;
+}
+QGroupBox::title {
+    left: 12px;
+    padding: 0 8px;
+    color: #00bfff;
+}
+
+QScrollArea {
+    border: none;
+}
+QScrollBar:vertical {
+    width: 12px;
+    border-radius: 6px;
+}
+QScrollBar::handle:vertical {
+    background-color: #1a3cff;
+    border-radius: 6px;
+    min-height: 20px;
+}
+QScrollBar::handle:vertical:hover {
+    background-color: #00bfff;
+}
+QTabWidget::pane {
+    border: 1px solid #2a3245;
+    background-color: #0d0d0d;
+    border-radius: 6px;
+    padding: 4px;
+}
+QTabBar::tab {
+    background-color: #1a1a1a;
+    color: #9ca0b0;
+    padding: 8px 20px;
+    font-family: 'Nimbus Mono';
+    font-size: 11pt;
+    border-top-left-radius: 6px;
+    border-top-right-radius: 6px;
+    margin: 2px;
+}
+QTabBar::tab:selected {
+    background-color: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #3a86ff, stop:1 #001f54);
+    color: #ffffff;
+    font-weight: bold;
+    border: 1px solid #3a86ff;
+}
+QTabBar::tab:!selected:hover {
+    background-color: #2a3245;
+    color: #ffffff;
+    border: 1px solid #5a6fff;
+    font-weight: bold;
+}
+
+QDialog[class="progressDialog"] {
+    background: #000;
+    color: #fff;
+}
+QDialog[class="progressDialog"] QLabel {
+    color: #fff;
+}
+
+QGroupBox[class="infoBox"] {
+    border: 1px solid #444;
+    margin-top: 0;
+}
+
+QLabel[class="infoText"] {
+    color: white;
+    font-size: 13px;
+    margin: 4px 0;
+}
+
+QPushButton[class="iconButton"] {
+    background: transparent;
+    border: none;
+}
+QPushButton[class="iconButton"]:hover {
+    background: rgba(255,255,255,0.1);
+    border-radius: 4px;
+}
+QPushButton[class="iconButton"][feedback="true"] {
+    background: rgba(30,144,255,0.3);
+}
+
+QLabel[warning="true"] {
+    color: #ff5555;
+    font-weight: bold;
+}
+)");
+}
+
+void setState(QWidget *widget, const char *name, const QVariant &value) {
+    widget->setProperty(name, value);
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+    widget->update();
+}
+}
+
 class SystemInfoFetcher {
 public:
     struct Info {
@@ -125,10 +302,6 @@ private:
             }
             if (pkgs > 0) return QString::number(pkgs);
         }
-
-        QProcess p;
-        p.start("lscpu");
-        p.waitForFinished(500);
         return "Unknown";
     }
 
@@ -155,15 +328,8 @@ private:
             quint64 total = s.bytesTotal();
             quint64 avail = s.bytesAvailable();
             quint64 used = (total > avail) ? (total - avail) : 0;
-            auto human = [](qulonglong bytes)->QString {
-                double b = bytes;
-                const char *units[] = {"B","KB","MB","GB","TB"};
-                int i = 0;
-                while (b >= 1024.0 && i < 4) { b /= 1024.0; ++i; }
-                return QString::number(b, 'f', (i == 0 ? 0 : 1)) + " " + units[i];
-            };
             QString pct = total ? QString::number(100.0 * used / (double)total, 'f', 0) : "??";
-            return QString("%1 / %2 (%3%)").arg(human(used), human(total), pct);
+            return QString("%1 / %2 (%3%)").arg(formatBytes(used), formatBytes(total), pct);
         }
         return "Unknown";
     }
@@ -214,254 +380,820 @@ private:
     }
 };
 
-class InstallProgressDialog : public QDialog {
-    Q_OBJECT
-public:
-    QLabel *infoLabel;
-    InstallProgressDialog(const QString &title, QWidget *parent = nullptr)
-        : QDialog(parent)
-    {
-        setWindowTitle(title);
-        setModal(true);
-        setFixedSize(420, 100);
-        setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
-        auto layout = new QVBoxLayout(this);
-        infoLabel = new QLabel("Running command...", this);
-        layout->addWidget(infoLabel);
-        setStyleSheet(
-            "QDialog { background: #000; font-family: 'Nimbus Mono'; color: #fff; }"
-            "QLabel { font-family:  'Nimbus Mono'; color: #fff; }"
-            );
-    }
-    void showInfo(const QString &msg) { infoLabel->setText(msg); }
-};
-QString findTerminal() {
-    QStringList terms = {"xterm", "konsole", "qterminal"};
-    auto it = std::find_if(terms.begin(), terms.end(), [](const QString &t) {
-        return !QStandardPaths::findExecutable(t).isEmpty();
-    });
-    return it != terms.end() ? *it : QString("");
-}
-void runInTerminal(const QString &cmd, QWidget *parent, const QString &desc = QString()) {
-    QString terminal = findTerminal();
-    auto dlg = new InstallProgressDialog(desc.isEmpty() ? "Running Command..." : desc, parent);
-    if (terminal.isEmpty()) {
-        dlg->showInfo("No supported terminal emulator found!\nSupported: xterm, konsole, qterminal\n install one");
-        dlg->show();
-        QTimer::singleShot(3500, dlg, &QDialog::accept);
-        return;
-    }
-    QStringList args;
-    QString fullCmd = QString("bash -c 'echo \"Running: %1\" && sudo %2; echo; echo \"Press Enter to close\"; read'").arg(cmd, cmd);
-    args << "-e" << fullCmd;
-
-    QProcess::startDetached(terminal, args);
-    dlg->showInfo(desc + "\nA terminal will open for authentication.");
-    dlg->show();
-    QTimer::singleShot(2000, dlg, &QDialog::accept);
-}
-
-
-
-class GlowingLogo : public QLabel {
-    Q_OBJECT
+class HardwareDetector {
 public:
-    GlowingLogo(QWidget *parent = nullptr) : QLabel(parent), clickCount(0) {
-        setMouseTracking(true);
-        setCursor(Qt::PointingHandCursor);
-    }
+    struct Gpu {
+        QString slot;
+        QString vendor;
+        quint16 vendorId = 0;
+        quint16 deviceId = 0;
+    };
 
-protected:
-    void enterEvent(QEnterEvent *event) override {
-        auto glow = new QGraphicsDropShadowEffect;
-        glow->setBlurRadius(25);
-        glow->setColor(QColor("#00BFFF"));
-        glow->setOffset(0);
-        setGraphicsEffect(glow);
-        QLabel::enterEvent(event);
+    // Display controllers are PCI class 0x03xxxx; sysfs answers this without
+    // spawning lspci.
+    static QList<Gpu> gpus() {
+        QList<Gpu> list;
+        const QString base = "/sys/bus/pci/devices";
+        for (const QString &slot : QDir(base).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+            if (!readId(base + "/" + slot + "/class").startsWith("0x03")) continue;
+            Gpu gpu;
+            gpu.slot = slot;
+            gpu.vendorId = readId(base + "/" + slot + "/vendor").toUShort(nullptr, 16);
+            gpu.deviceId = readId(base + "/" + slot + "/device").toUShort(nullptr, 16);
+            gpu.vendor = vendorName(gpu.vendorId);
+            list.append(gpu);
+        }
+        return list;
     }
 
-    void leaveEvent(QEvent *event) override {
-        setGraphicsEffect(nullptr);
-        QLabel::leaveEvent(event);
+    // A discrete card decides the driver story, so NVIDIA wins over AMD and
+    // AMD over an integrated Intel GPU.
+    static QString gpuVendor(const QList<Gpu> &list = gpus()) {
+        for (const char *vendor : {"nvidia", "amd", "intel"}) {
+            for (const Gpu &gpu : list)
+                if (gpu.vendor == vendor) return gpu.vendor;
+        }
+        return "unknown";
     }
 
-    void mousePressEvent(QMouseEvent *event) override {
-        if (event->button() == Qt::LeftButton) {
-            clickCount++;
-            if (clickCount >= 3) {
-                emit triggerMiniGame();
-                clickCount = 0;
-            }
+    static QString cpuVendor() {
+        QFile f("/proc/cpuinfo");
+        if (!f.open(QIODevice::ReadOnly)) return "unknown";
+        while (!f.atEnd()) {
+            const QByteArray line = f.readLine();
+            if (!line.startsWith("vendor_id")) continue;
+            const QByteArray id = line.mid(line.indexOf(':') + 1).trimmed();
+            if (id == "AuthenticAMD") return "amd";
+            if (id == "GenuineIntel") return "intel";
+            break;
         }
-        QLabel::mousePressEvent(event);
+        return "unknown";
     }
 
-signals:
-    void triggerMiniGame();
-
 private:
-    int clickCount;
+    static QString readId(const QString &path) {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) return QString();
+        return QString::fromLatin1(f.readAll().trimmed());
+    }
 
+    static QString vendorName(quint16 id) {
+        switch (id) {
+        case 0x10de: return "nvidia";
+        case 0x1002: case 0x1022: return "amd";
+        case 0x8086: return "intel";
+        default: return "unknown";
+        }
+    }
 };
 
-
-class MiniGameDialog : public QDialog {
-    Q_OBJECT
+class PackageIndex {
 public:
-    MiniGameDialog(QWidget *parent = nullptr) : QDialog(parent) {
-        setWindowIcon (QIcon::fromTheme ("<!>"));
-        setWindowTitle("Neospace 26 runner");
-        resize(700, 260);
-
-        jumpCountLabel = new QLabel("Jumps: 0", this);
-        jumpCountLabel->setGeometry(10, 8, 120, 20);
+    struct Package {
+        QString name;
+        QString version;
+        QString arch;
+        qint64 installedKb = 0;
+    };
 
-        powerupStatusLabel = new QLabel("Powerups: 0", this);
-        powerupStatusLabel->setGeometry(140, 8, 220, 20);
+    // Reads the dpkg status database directly; it is what dpkg-query
+    // consults anyway, minus the process start.
+    static QList<Package> installed(const QString &statusPath = "/var/lib/dpkg/status") {
+        QList<Package> list;
+        QFile f(statusPath);
+        if (!f.open(QIODevice::ReadOnly)) return list;
+
+        Package pkg;
+        bool isInstalled = false;
+        auto flush = [&]() {
+            if (isInstalled && !pkg.name.isEmpty()) list.append(pkg);
+            pkg = Package();
+            isInstalled = false;
+        };
 
-        player = new QLabel(this);
-        QPixmap pp;
-        QIcon themeIcon = QIcon::fromTheme("error.os");
-        if (!themeIcon.isNull()) {
-            pp = themeIcon.pixmap(32, 32);
-        } else {
-            pp = QPixmap(":/error.os.svgz");
-            if (pp.isNull()) pp = QPixmap(32, 32);
+        const QByteArray data = f.readAll();
+        for (const QByteArray &line : data.split('\n')) {
+            if (line.isEmpty()) { flush(); continue; }
+            if (line.startsWith(' ')) continue;
+            const int colon = line.indexOf(':');
+            if (colon < 0) continue;
+            const QByteArray field = line.left(colon);
+            const QByteArray value = line.mid(colon + 1).trimmed();
+            if (field == "Package") pkg.name = QString::fromUtf8(value);
+            else if (field == "Status") isInstalled = value.endsWith(" installed") && value.startsWith("install ");
+            else if (field == "Version") pkg.version = QString::fromUtf8(value);
+            else if (field == "Architecture") pkg.arch = QString::fromUtf8(value);
+            else if (field == "Installed-Size") pkg.installedKb = value.toLongLong();
         }
-        player->setPixmap(pp.scaled(playerWidth, playerHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        player->setGeometry(50, groundY - playerHeight, playerWidth, playerHeight);
-        playerY = groundY - playerHeight;
+        flush();
+        return list;
+    }
 
-        gameTimer = new QTimer(this);
-        connect(gameTimer, &QTimer::timeout, this, &MiniGameDialog::gameLoop);
-        gameTimer->start(gameIntervalMs);
+    static QStringList names() {
+        QStringList list;
+        for (const Package &pkg : installed())
+            list << pkg.name;
+        return list;
+    }
+};
 
-        spawnTimer = new QTimer(this);
-        connect(spawnTimer, &QTimer::timeout, this, &MiniGameDialog::spawnObstacle);
-        spawnTimer->start(spawnIntervalMs);
+// Fixed-work kernels, so a score only moves when the machine does. The
+// vector kernel is written with SSE2 (or NEON) intrinsics, both part of
+// the baseline ISA, so it runs the same instructions in every build.
+class Benchmark {
+public:
+    struct Test {
+        const char *id;
+        const char *name;
+        const char *unit;
+        bool lowerIsBetter;
+    };
 
-        powerupSpawnTimer = new QTimer(this);
-        connect(powerupSpawnTimer, &QTimer::timeout, this, &MiniGameDialog::spawnPowerup);
-        powerupSpawnTimer->start(powerupSpawnIntervalMs + QRandomGenerator::global()->bounded(powerupSpawnJitterMs));
+    struct Run {
+        qint64 timeMs = 0;
+        QString cpuModel;
+        int threads = 0;
+        QMap<QString, double> scores;
+    };
 
-        setFocusPolicy(Qt::StrongFocus);
+    static const QList<Test> &tests() {
+        static const QList<Test> list = {
+            {"cpu.int.single", "Integer, 1 thread", "M iter/s", false},
+            {"cpu.int.multi", "Integer, all threads", "M iter/s", false},
+            {"cpu.fp.single", "Floating point, 1 thread", "Mflop/s", false},
+            {"cpu.fp.multi", "Floating point, all threads", "Mflop/s", false},
+            {"cpu.simd.single", "128-bit vector multiply-add, 1 thread", "Gflop/s", false},
+            {"cpu.simd.multi", "128-bit vector multiply-add, all threads", "Gflop/s", false},
+            {"mem.copy", "Memory copy", "GB/s", false},
+            {"mem.triad", "Memory triad", "GB/s", false},
+            {"mem.latency", "Memory latency", "ns", true},
+            {"disk.seq.write", "Disk sequential write", "MB/s", false},
+            {"disk.seq.read", "Disk sequential read", "MB/s", false},
+            {"disk.rand.write", "Disk random 4K write", "IOPS", false},
+            {"disk.rand.read", "Disk random 4K read", "IOPS", false},
+        };
+        return list;
     }
 
-    ~MiniGameDialog() override {
-        qDeleteAll(obstacles);
-        obstacles.clear();
-        if (powerup) powerup->deleteLater();
+    // progress(i) is called before tests()[i] runs; returning false cancels.
+    static std::optional<Run> run(const std::function<bool(int)> &progress) {
+        Run r;
+        r.timeMs = QDateTime::currentMSecsSinceEpoch();
+        r.threads = int(qMax(1u, std::thread::hardware_concurrency()));
+        const int n = r.threads;
+        int step = 0;
+        auto next = [&]() { return progress(step++); };
+
+        constexpr quint64 intIterations = 200000000;
+        constexpr quint64 fpIterations = 50000000;
+        constexpr int simdPasses = 200000;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.int.single"] = intIterations / timed(1, [](int i) { sink += integerKernel(intIterations, i); }) / 1e6;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.int.multi"] = n * intIterations / timed(n, [](int i) { sink += integerKernel(intIterations, i); }) / 1e6;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.fp.single"] = 8.0 * fpIterations / timed(1, [](int i) { sink += quint64(floatKernel(fpIterations, i)); }) / 1e6;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.fp.multi"] = 8.0 * n * fpIterations / timed(n, [](int i) { sink += quint64(floatKernel(fpIterations, i)); }) / 1e6;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.simd.single"] = 2.0 * simdPasses * simdWidth / timed(1, [](int) { sink += quint64(simdKernel(simdPasses)); }) / 1e9;
+        if (!next()) return std::nullopt;
+        r.scores["cpu.simd.multi"] = 2.0 * n * simdPasses * simdWidth / timed(n, [](int) { sink += quint64(simdKernel(simdPasses)); }) / 1e9;
+
+        if (!memory(r, n, next)) return std::nullopt;
+        if (!disk(r, next)) return std::nullopt;
+        return r;
     }
 
-protected:
-    void keyPressEvent(QKeyEvent *e) override {
-        if ((e->key() == Qt::Key_Space) && !jumping) doJump();
-        QDialog::keyPressEvent(e);
+private:
+    static constexpr int simdWidth = 4096;
+    static inline std::atomic<quint64> sink{0};
+
+    template <typename Kernel>
+    static double timed(int threads, Kernel kernel) {
+        QElapsedTimer clock;
+        clock.start();
+        std::vector<std::thread> pool;
+        for (int i = 0; i < threads; ++i) pool.emplace_back(kernel, i);
+        for (auto &t : pool) t.join();
+        return qMax<qint64>(clock.nsecsElapsed(), 1) / 1e9;
     }
 
-    void mousePressEvent(QMouseEvent *e) override {
-        if (!jumping) doJump();
-        QDialog::mousePressEvent(e);
+    static quint64 integerKernel(quint64 iterations, int seed) {
+        quint64 x = 0x2545F4914F6CDD1Dull + quint64(seed), acc = 0;
+        for (quint64 i = 0; i < iterations; ++i) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            acc += (x * 0x9E3779B97F4A7C15ull) >> (x & 31);
+        }
+        return acc;
     }
 
-private slots:
-    void gameLoop() {
-        if (jumping) {
-            playerY += velocity;
-            velocity += gravity;
-            if (playerY >= groundY - playerHeight) {
-                playerY = groundY - playerHeight;
-                jumping = false;
-                velocity = 0;
+    static double floatKernel(quint64 iterations, int seed) {
+        double a = 1.0 + seed * 1e-3, b = 1.0000001, c = 0;
+        for (quint64 i = 0; i < iterations; ++i) {
+            a = a * b + 1e-7;
+            b = b * 0.9999999 + 1e-9;
+            c += a / (1.0 + b * b);
+        }
+        return a + b + c;
+    }
+
+    static float simdKernel(int passes) {
+        std::vector<float> x(simdWidth), y(simdWidth);
+        for (int i = 0; i < simdWidth; ++i) {
+            x[i] = 1.0f + i * 1e-4f;
+            y[i] = 0.5f;
+        }
+        for (int p = 0; p < passes; ++p) {
+            const float a = 0.999f + p * 1e-9f;
+#if defined(__SSE2__)
+            const __m128 va = _mm_set1_ps(a);
+            for (int i = 0; i < simdWidth; i += 4)
+                _mm_storeu_ps(&y[i], _mm_add_ps(_mm_mul_ps(va, _mm_loadu_ps(&x[i])), _mm_loadu_ps(&y[i])));
+#elif defined(__ARM_NEON)
+            const float32x4_t va = vdupq_n_f32(a);
+            for (int i = 0; i < simdWidth; i += 4)
+                vst1q_f32(&y[i], vaddq_f32(vmulq_f32(va, vld1q_f32(&x[i])), vld1q_f32(&y[i])));
+#else
+            for (int i = 0; i < simdWidth; ++i) y[i] = a * x[i] + y[i];
+#endif
+        }
+        return y[simdWidth / 2];
+    }
+
+    // STREAM-style copy and triad over three fixed 64 MB arrays, best of
+    // three, then a dependent pointer chase through a random cycle. The
+    // sizes never shrink; without room for them the memory tests report
+    // nothing rather than a figure for a different working set.
+    static bool memory(Run &r, int threads, const std::function<bool()> &next) {
+        constexpr size_t n = 8 << 20;
+        qint64 availableKb = 0;
+        QFile meminfo("/proc/meminfo");
+        if (meminfo.open(QIODevice::ReadOnly)) {
+            for (const QByteArray &line : meminfo.readAll().split('\n'))
+                if (line.startsWith("MemAvailable:")) availableKb = line.mid(13).trimmed().split(' ').first().toLongLong();
+        }
+        if (availableKb * 1024 < 2 * qint64(3 * n * sizeof(double) + (64 << 20))) {
+            for (int i = 0; i < 3; ++i)
+                if (!next()) return false;
+            return true;
+        }
+        std::vector<double> a(n, 1.0), b(n, 2.0), c(n, 0.0);
+        auto parallel = [&](auto body) {
+            return timed(threads, [&](int t) {
+                const size_t begin = n * t / threads, end = n * (t + 1) / threads;
+                body(begin, end);
+            });
+        };
+
+        if (!next()) return false;
+        double best = std::numeric_limits<double>::max();
+        for (int rep = 0; rep < 3; ++rep)
+            best = qMin(best, parallel([&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) c[i] = a[i];
+            }));
+        r.scores["mem.copy"] = 16.0 * n / best / 1e9;
+
+        if (!next()) return false;
+        best = std::numeric_limits<double>::max();
+        for (int rep = 0; rep < 3; ++rep)
+            best = qMin(best, parallel([&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) a[i] = b[i] + 3.0 * c[i];
+            }));
+        r.scores["mem.triad"] = 24.0 * n / best / 1e9;
+
+        if (!next()) return false;
+        constexpr size_t lines = (64 << 20) / 64;
+        constexpr size_t stride = 64 / sizeof(size_t);
+        std::vector<size_t> chain(lines * stride);
+        std::vector<size_t> order(lines);
+        std::iota(order.begin(), order.end(), size_t(0));
+        QRandomGenerator gen(42);
+        for (size_t i = lines - 1; i > 0; --i) std::swap(order[i], order[gen.bounded(quint64(i))]);
+        for (size_t i = 0; i < lines; ++i) chain[order[i] * stride] = order[(i + 1) % lines] * stride;
+        constexpr quint64 loads = 20000000;
+        const double seconds = timed(1, [&chain](int) {
+            size_t p = 0;
+            for (quint64 i = 0; i < loads; ++i) p = chain[p];
+            sink += p;
+        });
+        r.scores["mem.latency"] = seconds * 1e9 / loads;
+        return true;
+    }
+
+    // O_DIRECT keeps the page cache out of the numbers; filesystems that
+    // refuse it (tmpfs, some FUSE mounts) simply get no disk scores.
+    static bool disk(Run &r, const std::function<bool()> &next) {
+        constexpr qint64 fileSize = 256 << 20;
+        constexpr size_t block = 1 << 20;
+        constexpr size_t page = 4096;
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/err_";
+        QDir().mkpath(dir);
+        if (QStorageInfo(dir).bytesAvailable() < 2 * fileSize) {
+            for (int i = 0; i < 4; ++i)
+                if (!next()) return false;
+            return true;
+        }
+
+        const QByteArray path = QFile::encodeName(dir + "/benchmark.tmp");
+        const int fd = ::open(path.constData(), O_RDWR | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0600);
+        if (fd >= 0) ::unlink(path.constData());
+        void *raw = nullptr;
+        if (posix_memalign(&raw, page, block) != 0) raw = nullptr;
+        std::unique_ptr<char, decltype(&free)> buffer(static_cast<char *>(raw), &free);
+        const bool usable = fd >= 0 && buffer;
+        if (usable) {
+            QRandomGenerator gen(7);
+            gen.fillRange(reinterpret_cast<quint32 *>(buffer.get()), block / sizeof(quint32));
+        }
+
+        auto sequential = [&](bool write) {
+            QElapsedTimer clock;
+            clock.start();
+            for (qint64 off = 0; off < fileSize; off += block) {
+                const ssize_t done = write ? ::pwrite(fd, buffer.get(), block, off) : ::pread(fd, buffer.get(), block, off);
+                if (done != ssize_t(block)) return 0.0;
+            }
+            if (write) ::fdatasync(fd);
+            return fileSize / (qMax<qint64>(clock.nsecsElapsed(), 1) / 1e9) / 1e6;
+        };
+        auto random = [&](bool write) {
+            QRandomGenerator gen(write ? 11 : 13);
+            QElapsedTimer clock;
+            clock.start();
+            quint64 ops = 0;
+            while (clock.elapsed() < 1500 && ops < 200000) {
+                const qint64 off = qint64(gen.bounded(quint64(fileSize / page))) * page;
+                const ssize_t done = write ? ::pwrite(fd, buffer.get(), page, off) : ::pread(fd, buffer.get(), page, off);
+                if (done != ssize_t(page)) return 0.0;
+                ++ops;
+            }
+            if (write) ::fdatasync(fd);
+            return ops / (qMax<qint64>(clock.nsecsElapsed(), 1) / 1e9);
+        };
+
+        bool ok = true;
+        const std::pair<const char *, std::function<double()>> steps[] = {
+            {"disk.seq.write", [&]() { return sequential(true); }},
+            {"disk.seq.read", [&]() { return sequential(false); }},
+            {"disk.rand.write", [&]() { return random(true); }},
+            {"disk.rand.read", [&]() { return random(false); }},
+        };
+        for (const auto &[id, measure] : steps) {
+            if (!next()) {
+                ok = false;
+                break;
             }
-            player->move(player->x(), playerY);
+            if (!usable) continue;
+            const double score = measure();
+            if (score > 0) r.scores[id] = score;
         }
+        if (fd >= 0) ::close(fd);
+        return ok;
+    }
+};
 
-        for (int i = obstacles.size() - 1; i >= 0; --i) {
-            QLabel *obs = obstacles.at(i);
-            obs->move(obs->x() - obstacleSpeed, obs->y());
-            if (obs->x() + obs->width() < 0) {
-                obs->deleteLater();
-                obstacles.removeAt(i);
-            } else if (player->geometry().intersects(obs->geometry())) {
-                endGame();
-                return;
+QDataStream &operator<<(QDataStream &out, const SystemInfoFetcher::Info &info) {
+    return out << info.osName << info.osPretty << info.kernel << info.cpuArch << info.cpuModel
+               << info.cpuCores << info.physicalCores << info.ram << info.storage << info.hostname
+               << info.uptime << info.user << info.homePath << info.documentsPath
+               << info.downloadsPath << info.installDate << info.currentTime;
+}
+
+QDataStream &operator>>(QDataStream &in, SystemInfoFetcher::Info &info) {
+    return in >> info.osName >> info.osPretty >> info.kernel >> info.cpuArch >> info.cpuModel
+              >> info.cpuCores >> info.physicalCores >> info.ram >> info.storage >> info.hostname
+              >> info.uptime >> info.user >> info.homePath >> info.documentsPath
+              >> info.downloadsPath >> info.installDate >> info.currentTime;
+}
+
+QDataStream &operator<<(QDataStream &out, const HardwareDetector::Gpu &gpu) {
+    return out << gpu.slot << gpu.vendor << gpu.vendorId << gpu.deviceId;
+}
+
+QDataStream &operator>>(QDataStream &in, HardwareDetector::Gpu &gpu) {
+    return in >> gpu.slot >> gpu.vendor >> gpu.vendorId >> gpu.deviceId;
+}
+
+QDataStream &operator<<(QDataStream &out, const PackageIndex::Package &pkg) {
+    return out << pkg.name << pkg.version << pkg.arch << pkg.installedKb;
+}
+
+QDataStream &operator>>(QDataStream &in, PackageIndex::Package &pkg) {
+    return in >> pkg.name >> pkg.version >> pkg.arch >> pkg.installedKb;
+}
+
+QDataStream &operator<<(QDataStream &out, const Benchmark::Run &run) {
+    return out << run.timeMs << run.cpuModel << run.threads << run.scores;
+}
+
+QDataStream &operator>>(QDataStream &in, Benchmark::Run &run) {
+    return in >> run.timeMs >> run.cpuModel >> run.threads >> run.scores;
+}
+
+class InventorySnapshot {
+public:
+    static constexpr quint32 magic = 0x45525253; // "ERRS"
+    static constexpr quint16 version = 2;
+
+    qint64 createdMs = 0;
+    qint64 dpkgStatusMtime = 0;
+    SystemInfoFetcher::Info info;
+    QString cpuVendor;
+    QList<HardwareDetector::Gpu> gpus;
+    QList<PackageIndex::Package> packages;
+    QList<Benchmark::Run> benchmarks;
+
+    static QString path() {
+        return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/err_/inventory.snap";
+    }
+
+    static QString dpkgStatusPath() { return "/var/lib/dpkg/status"; }
+
+    void refreshSystem() {
+        info = SystemInfoFetcher::fetch();
+        cpuVendor = HardwareDetector::cpuVendor();
+        gpus = HardwareDetector::gpus();
+        createdMs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    void refreshPackages() {
+        dpkgStatusMtime = statusMtime();
+        packages = PackageIndex::installed(dpkgStatusPath());
+        createdMs = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    // The package index is the expensive part, and dpkg rewrites its status
+    // file on every transaction, so its mtime is enough to tell staleness.
+    bool packagesStale() const { return statusMtime() != dpkgStatusMtime; }
+
+    // Runs are kept with the machine they ran on, and only the last few,
+    // so a result can be compared against earlier ones.
+    void addBenchmark(Benchmark::Run run) {
+        if (info.cpuModel.isEmpty()) refreshSystem();
+        run.cpuModel = info.cpuModel;
+        benchmarks << run;
+        while (benchmarks.size() > 20) benchmarks.removeFirst();
+    }
+
+    QStringList packageNames() const {
+        QStringList names;
+        names.reserve(packages.size());
+        for (const auto &pkg : packages) names << pkg.name;
+        return names;
+    }
+
+    bool save(const QString &file = path()) const {
+        QDir().mkpath(QFileInfo(file).absolutePath());
+        QSaveFile f(file);
+        if (!f.open(QIODevice::WriteOnly)) return false;
+        QDataStream out(&f);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << magic << version << createdMs << dpkgStatusMtime << info << cpuVendor << gpus << packages << benchmarks;
+        return out.status() == QDataStream::Ok && f.commit();
+    }
+
+    // The file is mapped rather than read so startup only touches the pages
+    // it decodes; a missing, foreign or older snapshot just yields nothing.
+    static std::optional<InventorySnapshot> load(const QString &file = path()) {
+        QFile f(file);
+        if (!f.open(QIODevice::ReadOnly) || f.size() < 6) return std::nullopt;
+        uchar *data = f.map(0, f.size());
+        if (!data) return std::nullopt;
+
+        std::optional<InventorySnapshot> result;
+        {
+            const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), f.size());
+            QDataStream in(bytes);
+            in.setVersion(QDataStream::Qt_6_0);
+            quint32 fileMagic = 0;
+            quint16 fileVersion = 0;
+            in >> fileMagic >> fileVersion;
+            if (fileMagic == magic && fileVersion == version) {
+                InventorySnapshot snapshot;
+                in >> snapshot.createdMs >> snapshot.dpkgStatusMtime >> snapshot.info
+                   >> snapshot.cpuVendor >> snapshot.gpus >> snapshot.packages >> snapshot.benchmarks;
+                if (in.status() == QDataStream::Ok) result = std::move(snapshot);
             }
         }
+        f.unmap(data);
+        return result;
+    }
 
-        if (powerup) {
-            powerup->move(powerup->x() - obstacleSpeed, powerup->y());
-            if (powerup->x() + powerup->width() < 0) {
-                powerup->deleteLater();
-                powerup = nullptr;
-            } else if (player->geometry().intersects(powerup->geometry())) {
-                collectPowerup();
+    // The daemon, the GUI and --benchmark all rewrite the file, so each
+    // load-modify-save holds a lock next to it. Plain readers need none,
+    // since save() replaces the file by rename.
+    static bool update(const std::function<void(InventorySnapshot &)> &modify) {
+        QDir().mkpath(QFileInfo(path()).absolutePath());
+        QLockFile lock(path() + ".lock");
+        if (!lock.tryLock(10000)) return false;
+        InventorySnapshot snapshot = load().value_or(InventorySnapshot());
+        modify(snapshot);
+        return snapshot.save();
+    }
+
+    // Loaded once per process so every panel can paint from it at startup.
+    static const std::optional<InventorySnapshot> &cached() {
+        static const std::optional<InventorySnapshot> snapshot = load();
+        return snapshot;
+    }
+
+private:
+    static qint64 statusMtime() {
+        return QFileInfo(dpkgStatusPath()).lastModified().toMSecsSinceEpoch();
+    }
+};
+
+class InstallProgressDialog : public QDialog {
+    Q_OBJECT
+public:
+    QLabel *infoLabel;
+    InstallProgressDialog(const QString &title, QWidget *parent = nullptr)
+        : QDialog(parent)
+    {
+        setWindowTitle(title);
+        setModal(true);
+        setFixedSize(420, 100);
+        setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+        auto layout = new QVBoxLayout(this);
+        infoLabel = new QLabel("Running command...", this);
+        layout->addWidget(infoLabel);
+        setProperty("class", "progressDialog");
+    }
+    void showInfo(const QString &msg) { infoLabel->setText(msg); }
+};
+QString findTerminal() {
+    QStringList terms = {"xterm", "konsole", "qterminal"};
+    auto it = std::find_if(terms.begin(), terms.end(), [](const QString &t) {
+        return !QStandardPaths::findExecutable(t).isEmpty();
+    });
+    return it != terms.end() ? *it : QString("");
+}
+void runInTerminal(const QString &cmd, QWidget *parent, const QString &desc = QString()) {
+    QString terminal = findTerminal();
+    auto dlg = new InstallProgressDialog(desc.isEmpty() ? "Running Command..." : desc, parent);
+    if (terminal.isEmpty()) {
+        dlg->showInfo("No supported terminal emulator found!\nSupported: xterm, konsole, qterminal\n install one");
+        dlg->show();
+        QTimer::singleShot(3500, dlg, &QDialog::accept);
+        return;
+    }
+    QStringList args;
+    QString fullCmd = QString("bash -c 'echo \"Running: %1\" && sudo %2; echo; echo \"Press Enter to close\"; read'").arg(cmd, cmd);
+    args << "-e" << fullCmd;
+
+    QProcess::startDetached(terminal, args);
+    dlg->showInfo(desc + "\nA terminal will open for authentication.");
+    dlg->show();
+    QTimer::singleShot(2000, dlg, &QDialog::accept);
+}
+
+// Multi-step jobs go through a script file, since runInTerminal's
+// bash -c '...' wrapper cannot carry arbitrary quoting.
+void runScriptInTerminal(const QString &script, QWidget *parent, const QString &desc = QString()) {
+    QTemporaryFile file(QDir::tempPath() + "/err_-XXXXXX.sh");
+    file.setAutoRemove(false);
+    if (!file.open()) {
+        QMessageBox::warning(parent, "Error", "Could not write the temporary script.");
+        return;
+    }
+    file.write("trap 'rm -f \"$0\"' EXIT\n");
+    file.write(script.toUtf8());
+    file.close();
+    runInTerminal("sh " + file.fileName(), parent, desc);
+}
+
+
+
+class GlowingLogo : public QLabel {
+    Q_OBJECT
+public:
+    GlowingLogo(QWidget *parent = nullptr) : QLabel(parent), clickCount(0) {
+        setMouseTracking(true);
+        setCursor(Qt::PointingHandCursor);
+
+        fade.setStartValue(0.0);
+        fade.setEndValue(1.0);
+        fade.setDuration(150);
+        connect(&fade, &QVariantAnimation::valueChanged, this, [this](const QVariant &v) {
+            glowLevel = v.toReal();
+            update();
+        });
+    }
+
+    void setLogo(const QString &path, const QSize &size) {
+        logoPath = path;
+        logoSize = size;
+        loadLogo();
+    }
+
+    QSize sizeHint() const override {
+        return QLabel::sizeHint() + QSize(2 * glowRadius, 2 * glowRadius);
+    }
+
+    QSize minimumSizeHint() const override {
+        return QLabel::minimumSizeHint() + QSize(2 * glowRadius, 2 * glowRadius);
+    }
+
+protected:
+    void enterEvent(QEnterEvent *event) override {
+        fade.setDirection(QAbstractAnimation::Forward);
+        if (fade.state() != QAbstractAnimation::Running) fade.start();
+        QLabel::enterEvent(event);
+    }
+
+    void leaveEvent(QEvent *event) override {
+        fade.setDirection(QAbstractAnimation::Backward);
+        if (fade.state() != QAbstractAnimation::Running) fade.start();
+        QLabel::leaveEvent(event);
+    }
+
+    void paintEvent(QPaintEvent *event) override {
+        if (logoPath.isEmpty()) {
+            QLabel::paintEvent(event);
+            return;
+        }
+        if (!qFuzzyCompare(logo.devicePixelRatio(), devicePixelRatioF()))
+            loadLogo();
+
+        QPainter p(this);
+        if (glowLevel > 0) {
+            const QSizeF glowSize = glow.deviceIndependentSize();
+            p.setOpacity(glowLevel);
+            p.drawPixmap(QPointF((width() - glowSize.width()) / 2, (height() - glowSize.height()) / 2), glow);
+            p.setOpacity(1.0);
+        }
+        const QSizeF logical = logo.deviceIndependentSize();
+        p.drawPixmap(QPointF((width() - logical.width()) / 2, (height() - logical.height()) / 2), logo);
+    }
+
+    void mousePressEvent(QMouseEvent *event) override {
+        if (event->button() == Qt::LeftButton) {
+            clickCount++;
+            if (clickCount >= 3) {
+                emit triggerMiniGame();
+                clickCount = 0;
             }
         }
+        QLabel::mousePressEvent(event);
     }
 
-    void spawnObstacle() {
-        QLabel *obs = new QLabel(this);
-        QStringList emojis = {
-            QString::fromUtf8("🧱"),
-            QString::fromUtf8("💀"),
-            QString::fromUtf8("🌵"),
-            QString::fromUtf8("🪨"),
-            QString::fromUtf8("🔥"),
-            QString::fromUtf8("🌊")
-        };
-        int idx = QRandomGenerator::global()->bounded(emojis.size());
-        obs->setText(emojis.at(idx));
-        obs->setAlignment(Qt::AlignCenter);
-        obs->setGeometry(width(), groundY - obstacleHeight, obstacleWidth, obstacleHeight);
-        obs->show();
-        obstacles.append(obs);
-        spawnTimer->start(spawnIntervalMs + QRandomGenerator::global()->bounded(spawnIntervalJitterMs));
+signals:
+    void triggerMiniGame();
+
+private:
+    // Both the logo and its glow are rendered once per size and DPR and then
+    // shared through QPixmapCache, so hovering only changes an opacity.
+    void loadLogo() {
+        const qreal dpr = devicePixelRatioF();
+        const QString key = QString("err_logo:%1:%2x%3@%4").arg(logoPath).arg(logoSize.width()).arg(logoSize.height()).arg(dpr);
+        if (!QPixmapCache::find(key, &logo)) {
+            logo = QIcon(logoPath).pixmap(logoSize, dpr);
+            QPixmapCache::insert(key, logo);
+        }
+        if (!QPixmapCache::find(key + ":glow", &glow)) {
+            glow = renderGlow(logo, glowRadius, QColor("#00BFFF"));
+            QPixmapCache::insert(key + ":glow", glow);
+        }
+        setPixmap(logo);
     }
 
-    void spawnPowerup() {
-        if (powerup) return;
-
-        QStringList emojis = {
-            QString::fromUtf8("💠"),
-            QString::fromUtf8("💣"),     //very coonfusing indeed
-            QString::fromUtf8("🥭"),
-            QString::fromUtf8("🥚"),
-            QString::fromUtf8("🗿"),
-            QString::fromUtf8("🧨")
-        };
-        int idx = QRandomGenerator::global()->bounded(emojis.size());
+    static QPixmap renderGlow(const QPixmap &source, int radius, const QColor &color) {
+        const qreal dpr = source.devicePixelRatio();
+        const int pad = qCeil(radius * dpr);
+
+        QImage tinted = source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        tinted.setDevicePixelRatio(1.0);
+        QPainter tint(&tinted);
+        tint.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        tint.fillRect(tinted.rect(), color);
+        tint.end();
+
+        QGraphicsScene scene;
+        QGraphicsPixmapItem *item = scene.addPixmap(QPixmap::fromImage(tinted));
+        auto blur = new QGraphicsBlurEffect;
+        blur->setBlurRadius(radius * dpr);
+        blur->setBlurHints(QGraphicsBlurEffect::QualityHint);
+        item->setGraphicsEffect(blur);
+
+        QImage out(tinted.size() + QSize(2 * pad, 2 * pad), QImage::Format_ARGB32_Premultiplied);
+        out.fill(Qt::transparent);
+        QPainter p(&out);
+        scene.render(&p, QRectF(out.rect()), QRectF(-pad, -pad, out.width(), out.height()));
+        p.end();
+
+        QPixmap glow = QPixmap::fromImage(out);
+        glow.setDevicePixelRatio(dpr);
+        return glow;
+    }
+
+    int clickCount;
+    QString logoPath;
+    QSize logoSize;
+    QPixmap logo;
+    QPixmap glow;
+    QVariantAnimation fade;
+    qreal glowLevel = 0;
+    static constexpr int glowRadius = 25;
+
+};
+
+
+class MiniGameDialog : public QDialog {
+    Q_OBJECT
+public:
+    MiniGameDialog(QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowIcon (QIcon::fromTheme ("<!>"));
+        setWindowTitle("Neospace 26 runner");
+        resize(700, 260);
+        setAttribute(Qt::WA_OpaquePaintEvent);
+
+        QPixmap pp;
+        QIcon themeIcon = QIcon::fromTheme("error.os");
+        if (!themeIcon.isNull()) {
+            pp = themeIcon.pixmap(32, 32);
+        } else {
+            pp = QPixmap(":/error.os.svgz");
+            if (pp.isNull()) pp = QPixmap(32, 32);
+        }
+        playerSource = pp;
+        playerY = prevPlayerY = groundY - playerHeight;
+        updateHud();
 
-        powerup = new QLabel(this);
-        powerup->setText(emojis.at(idx));
-        powerup->setAlignment(Qt::AlignCenter);
-        powerup->setGeometry(width() - 42, groundY - playerHeight - 36, 32, 32);
-        powerup->setToolTip(QStringLiteral("Powerup: %1").arg(emojis.at(idx)));
-        powerup->show();
+        nextObstacleIn = spawnIntervalMs / 1000.0;
+        nextPowerupIn = (powerupSpawnIntervalMs + QRandomGenerator::global()->bounded(powerupSpawnJitterMs)) / 1000.0;
+
+        frameTimer.setSingleShot(true);
+        frameTimer.setTimerType(Qt::PreciseTimer);
+        connect(&frameTimer, &QTimer::timeout, this, qOverload<>(&QWidget::update));
+        frameClock.start();
+
+        setFocusPolicy(Qt::StrongFocus);
     }
 
-    void collectPowerup() {
-        if (!powerup) return;
-        powerup->deleteLater();
-        powerup = nullptr;
-        ++permanentPowerups;
-        obstacleSpeed = int(obstacleSpeed * speedBoostMultiplier);
-        if (obstacleSpeed > maxObstacleSpeed) obstacleSpeed = maxObstacleSpeed;
-        powerupStatusLabel->setText(QString("Powerups: %1").arg(permanentPowerups));
+protected:
+    void keyPressEvent(QKeyEvent *e) override {
+        if ((e->key() == Qt::Key_Space) && !jumping) doJump();
+        if (e->key() == Qt::Key_F3) showFrameStats = !showFrameStats;
+        QDialog::keyPressEvent(e);
+    }
+
+    void mousePressEvent(QMouseEvent *e) override {
+        if (!jumping) doJump();
+        QDialog::mousePressEvent(e);
     }
 
-    void removeAllObstacles() {
-        QList<QLabel*> old;
-        old.swap(obstacles);
-        for (QLabel *l : old)
-            if (l) l->deleteLater();
+    // Each frame advances the simulation in fixed steps, draws the state
+    // interpolated between the last two steps and then books the next frame
+    // one refresh interval after this one started.
+    void paintEvent(QPaintEvent *) override {
+        if (atlas.isNull() || !qFuzzyCompare(atlas.devicePixelRatio(), devicePixelRatioF()))
+            buildAtlas();
+
+        const double frameMs = frameClock.nsecsElapsed() / 1e6;
+        frameClock.restart();
+        recordFrame(frameMs);
+
+        if (!gameOver) {
+            accumulator += qMin(frameMs / 1000.0, maxFrameTime);
+            while (accumulator >= fixedStep) {
+                step(fixedStep);
+                accumulator -= fixedStep;
+                if (gameOver) break;
+            }
+        }
+        const double alpha = accumulator / fixedStep;
+
+        QPainter p(this);
+        p.fillRect(rect(), palette().window());
+        p.setPen(palette().windowText().color());
+        p.drawStaticText(10, 8, jumpText);
+        p.drawStaticText(140, 8, powerupText);
+
+        p.drawPixmap(QPointF(playerX, lerp(prevPlayerY, playerY, alpha)), playerSprite);
+        for (int i = 0; i < obstacleCount; ++i) {
+            const Obstacle &obs = obstacles[i];
+            p.drawPixmap(QPointF(lerp(obs.prevX, obs.x, alpha), groundY - obstacleHeight), atlas, spriteRects.at(obs.sprite));
+        }
+        if (powerup.active)
+            p.drawPixmap(QPointF(lerp(powerup.prevX, powerup.x, alpha), powerupY), atlas, spriteRects.at(powerup.sprite));
+
+        if (showFrameStats) drawFrameStats(p);
+
+        if (gameOver) {
+            if (!endQueued) QMetaObject::invokeMethod(this, &MiniGameDialog::endGame, Qt::QueuedConnection);
+            endQueued = true;
+            return;
+        }
+        const double budgetMs = 1000.0 / qMax(30.0, qreal(screen()->refreshRate()));
+        frameTimer.start(qMax(0, int(budgetMs - frameClock.nsecsElapsed() / 1e6)));
     }
 
+private slots:
     void endGame() {
-        gameTimer->stop();
-        spawnTimer->stop();
-        powerupSpawnTimer->stop();
+        frameTimer.stop();
 
         QStringList messages = {
             "You failed spectacularly! Total jumps: %1",
@@ -495,54 +1227,1046 @@ private slots:
 
         QMessageBox::information(this, "Game Over", message);
 
-        removeAllObstacles();
-        if (powerup) { powerup->deleteLater(); powerup = nullptr; }
+        obstacleCount = 0;
+        powerup.active = false;
         accept();
     }
 
 private:
-    void doJump() {
-        jumping = true;
-        velocity = initialJumpVelocity;
-        ++jumpCount;
-        jumpCountLabel->setText(QString("Jumps: %1").arg(jumpCount));
+    static double lerp(double a, double b, double t) { return a + (b - a) * t; }
+
+    // Swept test: the boxes cover everything both objects touched during the step,
+    // so nothing can pass through the player between two steps however fast it is.
+    bool sweptHit(double x0, double x1, double y, double w, double h) const {
+        const QRectF playerSwept(playerX, qMin(prevPlayerY, playerY), playerWidth,
+                                 playerHeight + qAbs(playerY - prevPlayerY));
+        const QRectF objectSwept(qMin(x0, x1), y, w + qAbs(x0 - x1), h);
+        return playerSwept.intersects(objectSwept);
     }
 
-private:
-    QLabel *player = nullptr;
-    QList<QLabel*> obstacles;
-    QLabel *powerup = nullptr;
-    QLabel *jumpCountLabel = nullptr;
-    QLabel *powerupStatusLabel = nullptr;
-    QTimer *gameTimer = nullptr;
-    QTimer *spawnTimer = nullptr;
-    QTimer *powerupSpawnTimer = nullptr;
+    void step(double dt) {
+        prevPlayerY = playerY;
+        if (jumping) {
+            playerY += velocity * dt;
+            velocity += gravity * dt;
+            if (playerY >= groundY - playerHeight) {
+                playerY = groundY - playerHeight;
+                jumping = false;
+                velocity = 0;
+            }
+        }
 
-    const int groundY = 200;
-    int playerY = groundY - 32;
-    const int playerHeight = 32;
-    const int playerWidth = 32;
-    int velocity = 0;
-    bool jumping = false;
-    int jumpCount = 0;
+        nextObstacleIn -= dt;
+        if (nextObstacleIn <= 0) spawnObstacle();
+        nextPowerupIn -= dt;
+        if (nextPowerupIn <= 0) spawnPowerup();
+
+        const double dx = obstacleSpeed * dt;
+        for (int i = obstacleCount - 1; i >= 0; --i) {
+            Obstacle &obs = obstacles[i];
+            obs.prevX = obs.x;
+            obs.x -= dx;
+            if (obs.x + obstacleWidth < 0) {
+                obstacles[i] = obstacles[--obstacleCount];
+            } else if (sweptHit(obs.prevX, obs.x, groundY - obstacleHeight, obstacleWidth, obstacleHeight)) {
+                gameOver = true;
+                return;
+            }
+        }
 
-    int obstacleWidth = 20;
-    int obstacleHeight = 20;
-    int obstacleSpeed = 5;
-    const int maxObstacleSpeed = 40;
-    const int gameIntervalMs = 30;
-    const int spawnIntervalMs = 1400;
-    const int spawnIntervalJitterMs = 800;
+        if (powerup.active) {
+            powerup.prevX = powerup.x;
+            powerup.x -= dx;
+            if (powerup.x + powerupSize < 0) {
+                powerup.active = false;
+            } else if (sweptHit(powerup.prevX, powerup.x, powerupY, powerupSize, powerupSize)) {
+                collectPowerup();
+            }
+        }
+    }
 
-    const int gravity = 1;
-    const int initialJumpVelocity = -12;
+    void spawnObstacle() {
+        if (obstacleCount < int(obstacles.size())) {
+            Obstacle &obs = obstacles[obstacleCount++];
+            obs.sprite = QRandomGenerator::global()->bounded(int(obstacleGlyphs.size()));
+            obs.x = obs.prevX = width();
+        }
+        nextObstacleIn = (spawnIntervalMs + QRandomGenerator::global()->bounded(spawnIntervalJitterMs)) / 1000.0;
+    }
 
-    const int powerupSpawnIntervalMs = 9000;
-    const int powerupSpawnJitterMs = 6000;
-    const double speedBoostMultiplier = 1.5;
+    void spawnPowerup() {
+        nextPowerupIn = (powerupSpawnIntervalMs + QRandomGenerator::global()->bounded(powerupSpawnJitterMs)) / 1000.0;
+        if (powerup.active) return;
+        powerup.sprite = obstacleGlyphs.size() + QRandomGenerator::global()->bounded(int(powerupGlyphs.size()));
+        powerup.x = powerup.prevX = width() - 42;
+        powerup.active = true;
+    }
+
+    void collectPowerup() {
+        powerup.active = false;
+        ++permanentPowerups;
+        obstacleSpeed = qMin(obstacleSpeed * speedBoostMultiplier, maxObstacleSpeed);
+        updateHud();
+    }
+
+    void recordFrame(double ms) {
+        frameTimes[frameIndex] = float(ms);
+        frameIndex = (frameIndex + 1) % frameTimes.size();
+        frameSamples = qMin(frameSamples + 1, int(frameTimes.size()));
+    }
+
+    // Histogram of the last frameTimes.size() frames in 1 ms buckets, plus average and p99.
+    void drawFrameStats(QPainter &p) {
+        std::array<int, 50> buckets = {};
+        std::array<float, 240> sorted;
+        double total = 0;
+        for (int i = 0; i < frameSamples; ++i) {
+            total += frameTimes[i];
+            buckets[qBound(0, int(frameTimes[i]), int(buckets.size()) - 1)]++;
+            sorted[i] = frameTimes[i];
+        }
+        if (frameSamples == 0) return;
+        std::nth_element(sorted.begin(), sorted.begin() + frameSamples * 99 / 100, sorted.begin() + frameSamples);
+        const double p99 = sorted[frameSamples * 99 / 100];
+        const double avg = total / frameSamples;
+
+        const QRectF area(width() - 220, 8, 200, 80);
+        p.fillRect(area, QColor(0, 0, 0, 180));
+        const int peak = *std::max_element(buckets.begin(), buckets.end());
+        const double barWidth = area.width() / buckets.size();
+        for (int i = 0; i < int(buckets.size()); ++i) {
+            if (!buckets[i]) continue;
+            const double h = (area.height() - 20) * buckets[i] / peak;
+            p.fillRect(QRectF(area.left() + i * barWidth, area.bottom() - h, barWidth - 1, h),
+                       i < 17 ? QColor("#00bfff") : QColor("#ff5555"));
+        }
+        if (statsClock.isValid() && statsClock.elapsed() < 500) {
+            p.drawStaticText(area.topLeft() + QPointF(4, 2), statsText);
+            return;
+        }
+        statsClock.start();
+        statsText.setText(QString("%1 fps  avg %2 ms  p99 %3 ms")
+                              .arg(1000.0 / avg, 0, 'f', 0).arg(avg, 0, 'f', 1).arg(p99, 0, 'f', 1));
+        p.drawStaticText(area.topLeft() + QPointF(4, 2), statsText);
+    }
+
+    void doJump() {
+        jumping = true;
+        velocity = initialJumpVelocity;
+        ++jumpCount;
+        updateHud();
+    }
+
+    void updateHud() {
+        jumpText.setText(QString("Jumps: %1").arg(jumpCount));
+        powerupText.setText(QString("Powerups: %1").arg(permanentPowerups));
+    }
+
+    // Every emoji is shaped and rasterised once; frames only blit from the atlas.
+    void buildAtlas() {
+        const qreal dpr = devicePixelRatioF();
+        const QStringList glyphs = obstacleGlyphs + powerupGlyphs;
+
+        spriteRects.clear();
+        int x = 0;
+        for (int i = 0; i < glyphs.size(); ++i) {
+            const int size = i < obstacleGlyphs.size() ? obstacleWidth : powerupSize;
+            spriteRects << QRectF(x, 0, size, size);
+            x += size;
+        }
+
+        atlas = QPixmap(QSize(x, powerupSize) * dpr);
+        atlas.setDevicePixelRatio(dpr);
+        atlas.fill(Qt::transparent);
+        QPainter p(&atlas);
+        p.setPen(palette().windowText().color());
+        for (int i = 0; i < glyphs.size(); ++i) {
+            QFont f = font();
+            f.setPixelSize(int(spriteRects.at(i).height() * 0.75));
+            p.setFont(f);
+            p.drawText(spriteRects.at(i), Qt::AlignCenter, glyphs.at(i));
+        }
+        p.end();
+
+        for (QRectF &r : spriteRects)
+            r = QRectF(r.topLeft() * dpr, r.size() * dpr);
+
+        playerSprite = playerSource.scaled(QSize(playerWidth, playerHeight) * dpr, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        playerSprite.setDevicePixelRatio(dpr);
+    }
+
+    struct Obstacle {
+        double x = 0;
+        double prevX = 0;
+        int sprite = 0;
+    };
+
+    struct Powerup {
+        double x = 0;
+        double prevX = 0;
+        int sprite = 0;
+        bool active = false;
+    };
+
+    const QStringList obstacleGlyphs = {
+        QString::fromUtf8("🧱"),
+        QString::fromUtf8("💀"),
+        QString::fromUtf8("🌵"),
+        QString::fromUtf8("🪨"),
+        QString::fromUtf8("🔥"),
+        QString::fromUtf8("🌊")
+    };
+    const QStringList powerupGlyphs = {
+        QString::fromUtf8("💠"),
+        QString::fromUtf8("💣"),     //very coonfusing indeed
+        QString::fromUtf8("🥭"),
+        QString::fromUtf8("🥚"),
+        QString::fromUtf8("🗿"),
+        QString::fromUtf8("🧨")
+    };
+
+    QPixmap playerSource;
+    QPixmap playerSprite;
+    QPixmap atlas;
+    QList<QRectF> spriteRects;
+    std::array<Obstacle, 16> obstacles;
+    int obstacleCount = 0;
+    Powerup powerup;
+    QStaticText jumpText;
+    QStaticText powerupText;
+    QStaticText statsText;
+    QTimer frameTimer;
+    QElapsedTimer frameClock;
+    QElapsedTimer statsClock;
+    std::array<float, 240> frameTimes = {};
+    int frameIndex = 0;
+    int frameSamples = 0;
+    bool showFrameStats = false;
+
+    const double fixedStep = 1.0 / 120.0;
+    const double maxFrameTime = 0.25;
+    double accumulator = 0;
+    double nextObstacleIn = 0;
+    double nextPowerupIn = 0;
+    bool gameOver = false;
+    bool endQueued = false;
+
+    const int groundY = 200;
+    const int playerX = 50;
+    const int playerHeight = 32;
+    const int playerWidth = 32;
+    const int powerupY = groundY - 32 - 36;
+    double playerY = groundY - 32;
+    double prevPlayerY = groundY - 32;
+    double velocity = 0;
+    bool jumping = false;
+    int jumpCount = 0;
+
+    int obstacleWidth = 20;
+    int obstacleHeight = 20;
+    const int powerupSize = 32;
+    double obstacleSpeed = 166.0;           // px/s
+    const double maxObstacleSpeed = 1333.0;
+    const int spawnIntervalMs = 1400;
+    const int spawnIntervalJitterMs = 800;
+
+    const double gravity = 1111.0;           // px/s^2
+    const double initialJumpVelocity = -400.0;
+
+    const int powerupSpawnIntervalMs = 9000;
+    const int powerupSpawnJitterMs = 6000;
+    const double speedBoostMultiplier = 1.5;
+
+    int permanentPowerups = 0;
+};
+class MetricsStore {
+public:
+    enum Metric { CpuLoad, MemoryUsed, SwapUsed, RootUsed, LoadAverage, MetricCount };
+    enum Tier { Minute, Hour, Day, TierCount };
+
+    struct Sample {
+        qint64 time = 0;
+        std::array<qint32, MetricCount> values{};
+    };
+
+    static QString directory() {
+        return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/err_/metrics";
+    }
+
+    static QString tierPath(Tier tier) {
+        static const char *names[] = {"minute", "hour", "day"};
+        return directory() + "/" + names[tier] + ".ts";
+    }
+
+    static qint64 step(Tier tier) {
+        static const qint64 seconds[] = {60, 3600, 86400};
+        return seconds[tier];
+    }
+
+    // A week of minutes, a year of hours and ten years of days: well under
+    // a megabyte on disk at twelve bytes a record.
+    static qsizetype capacity(Tier tier) {
+        static const qsizetype records[] = {7 * 1440, 366 * 24, 3660};
+        return records[tier];
+    }
+
+    // validSize receives the offset just past the last complete record.
+    static QList<Sample> read(Tier tier, qint64 since = 0, qint64 *validSize = nullptr) {
+        QList<Sample> samples;
+        if (validSize) *validSize = 0;
+        QFile f(tierPath(tier));
+        if (!f.open(QIODevice::ReadOnly)) return samples;
+        const QByteArray data = f.readAll();
+        if (data.size() < headerSize || qFromLittleEndian<quint32>(data.constData()) != magic) return samples;
+
+        Sample current;
+        const char *p = data.constData() + headerSize;
+        const char *end = data.constData() + data.size();
+        while (end - p >= recordSize) {
+            if (qFromLittleEndian<quint16>(p) == keyframeMarker) {
+                if (end - p < keyframeSize) break;
+                current.time = qFromLittleEndian<qint64>(p + 2);
+                for (int m = 0; m < MetricCount; ++m)
+                    current.values[m] = qFromLittleEndian<qint32>(p + 10 + 4 * m);
+                p += keyframeSize;
+            } else {
+                current.time += qFromLittleEndian<quint16>(p) * step(tier);
+                for (int m = 0; m < MetricCount; ++m)
+                    current.values[m] += qFromLittleEndian<qint16>(p + 2 + 2 * m);
+                p += recordSize;
+            }
+            if (current.time >= since) samples.append(current);
+        }
+        if (validSize) *validSize = p - data.constData();
+        return samples;
+    }
+
+    // Only the holder of the lock appends; every other process just reads.
+    bool openForWriting() {
+        QDir().mkpath(directory());
+        lock = std::make_unique<QLockFile>(directory() + "/writer.lock");
+        // Held for as long as the writer runs, so only a dead holder is stale.
+        lock->setStaleLockTime(0);
+        if (!lock->tryLock(0)) {
+            lock.reset();
+            return false;
+        }
+        for (int t = 0; t < TierCount; ++t) {
+            // A record torn by a crash would misalign everything appended
+            // after it, so the tail is cut back to the last whole record.
+            qint64 validSize = 0;
+            const QList<Sample> existing = read(Tier(t), 0, &validSize);
+            if (QFileInfo(tierPath(Tier(t))).size() > validSize) QFile::resize(tierPath(Tier(t)), validSize);
+            count[t] = existing.size();
+            last[t] = existing.isEmpty() ? std::nullopt : std::optional<Sample>(existing.last());
+        }
+        return true;
+    }
+
+    std::optional<Sample> lastSample(Tier tier) const { return last[tier]; }
+
+    void append(Tier tier, const Sample &sample) {
+        if (!lock) return;
+        if (count[tier] >= capacity(tier)) compact(tier);
+
+        QFile f(tierPath(tier));
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) return;
+        if (f.size() == 0) {
+            f.write(header());
+            last[tier].reset();
+        }
+        f.write(encode(tier, sample, last[tier]));
+        last[tier] = sample;
+        ++count[tier];
+    }
+
+private:
+    static constexpr quint32 magic = 0x4d525245; // "ERRM"
+    static constexpr quint16 version = 1;
+    static constexpr int headerSize = 8;
+    static constexpr int recordSize = 2 + 2 * MetricCount;
+    static constexpr int keyframeSize = 3 * recordSize;
+    static constexpr quint16 keyframeMarker = 0xffff;
+
+    static QByteArray header() {
+        QByteArray bytes(headerSize, '\0');
+        qToLittleEndian<quint32>(magic, bytes.data());
+        qToLittleEndian<quint16>(version, bytes.data() + 4);
+        qToLittleEndian<quint16>(recordSize, bytes.data() + 6);
+        return bytes;
+    }
+
+    // Records hold the step count since the previous sample and a 16-bit
+    // delta per metric; anything that does not fit becomes a keyframe with
+    // absolute values spanning three records.
+    static QByteArray encode(Tier tier, const Sample &sample, const std::optional<Sample> &prev) {
+        if (prev && sample.time > prev->time && (sample.time - prev->time) % step(tier) == 0) {
+            const qint64 steps = (sample.time - prev->time) / step(tier);
+            bool fits = steps < keyframeMarker;
+            for (int m = 0; m < MetricCount && fits; ++m) {
+                const qint64 delta = qint64(sample.values[m]) - prev->values[m];
+                fits = delta >= std::numeric_limits<qint16>::min() && delta <= std::numeric_limits<qint16>::max();
+            }
+            if (fits) {
+                QByteArray bytes(recordSize, '\0');
+                qToLittleEndian<quint16>(quint16(steps), bytes.data());
+                for (int m = 0; m < MetricCount; ++m)
+                    qToLittleEndian<qint16>(qint16(sample.values[m] - prev->values[m]), bytes.data() + 2 + 2 * m);
+                return bytes;
+            }
+        }
+        QByteArray bytes(keyframeSize, '\0');
+        qToLittleEndian<quint16>(keyframeMarker, bytes.data());
+        qToLittleEndian<qint64>(sample.time, bytes.data() + 2);
+        for (int m = 0; m < MetricCount; ++m)
+            qToLittleEndian<qint32>(sample.values[m], bytes.data() + 10 + 4 * m);
+        return bytes;
+    }
+
+    void compact(Tier tier) {
+        const QList<Sample> samples = read(tier);
+        const QList<Sample> kept = samples.mid(samples.size() - capacity(tier) / 2);
+        QSaveFile f(tierPath(tier));
+        if (!f.open(QIODevice::WriteOnly)) return;
+        f.write(header());
+        std::optional<Sample> prev;
+        for (const Sample &sample : kept) {
+            f.write(encode(tier, sample, prev));
+            prev = sample;
+        }
+        if (f.commit()) {
+            count[tier] = kept.size();
+            last[tier] = prev;
+        }
+    }
+
+    std::unique_ptr<QLockFile> lock;
+    std::array<qsizetype, TierCount> count{};
+    std::array<std::optional<Sample>, TierCount> last;
+};
+
+class MetricsSampler : public QObject {
+    Q_OBJECT
+public:
+    explicit MetricsSampler(QObject *parent = nullptr) : QObject(parent) {
+        connect(&timer, &QTimer::timeout, this, &MetricsSampler::sample);
+        timer.start(5000);
+        sample();
+    }
+
+private slots:
+    // The GUI and the inventory daemon both run a sampler; whichever does
+    // not hold the writer lock keeps retrying so it can take over when the
+    // other one exits.
+    void sample() {
+        if (!writing) {
+            if (!store.openForWriting()) return;
+            writing = true;
+            replayRollups();
+        }
+        std::array<qint32, MetricsStore::MetricCount> values{};
+        if (!readValues(values)) return;
+
+        const qint64 minute = QDateTime::currentSecsSinceEpoch() / 60 * 60;
+        if (pending[MetricsStore::Minute].samples > 0 && pending[MetricsStore::Minute].start != minute) {
+            const MetricsStore::Sample done = pending[MetricsStore::Minute].average();
+            store.append(MetricsStore::Minute, done);
+            roll(MetricsStore::Hour, done);
+            pending[MetricsStore::Minute] = Accumulator();
+        }
+        pending[MetricsStore::Minute].start = minute;
+        pending[MetricsStore::Minute].add(values);
+    }
+
+private:
+    struct Accumulator {
+        qint64 start = 0;
+        int samples = 0;
+        std::array<qint64, MetricsStore::MetricCount> sum{};
+
+        void add(const std::array<qint32, MetricsStore::MetricCount> &values) {
+            for (int m = 0; m < MetricsStore::MetricCount; ++m) sum[m] += values[m];
+            ++samples;
+        }
+
+        MetricsStore::Sample average() const {
+            MetricsStore::Sample out;
+            out.time = start;
+            for (int m = 0; m < MetricsStore::MetricCount; ++m) out.values[m] = qint32(sum[m] / samples);
+            return out;
+        }
+    };
+
+    // Hours roll up from minutes and days from hours, each written when the
+    // next sample crosses its boundary.
+    void roll(MetricsStore::Tier tier, const MetricsStore::Sample &sample) {
+        Accumulator &acc = pending[tier];
+        const qint64 boundary = sample.time / MetricsStore::step(tier) * MetricsStore::step(tier);
+        if (acc.samples > 0 && acc.start != boundary) {
+            const MetricsStore::Sample done = acc.average();
+            store.append(tier, done);
+            if (tier == MetricsStore::Hour) roll(MetricsStore::Day, done);
+            acc = Accumulator();
+        }
+        acc.start = boundary;
+        acc.add(sample.values);
+    }
+
+    // Rebuilds the open hour and day from disk so a restart neither loses
+    // nor double counts them; rollups missed while stopped are written now.
+    void replayRollups() {
+        const auto lastDay = store.lastSample(MetricsStore::Day);
+        for (const auto &s : MetricsStore::read(MetricsStore::Hour, lastDay ? lastDay->time + MetricsStore::step(MetricsStore::Day) : 0))
+            roll(MetricsStore::Day, s);
+        const auto lastHour = store.lastSample(MetricsStore::Hour);
+        for (const auto &s : MetricsStore::read(MetricsStore::Minute, lastHour ? lastHour->time + MetricsStore::step(MetricsStore::Hour) : 0))
+            roll(MetricsStore::Hour, s);
+    }
+
+    bool readValues(std::array<qint32, MetricsStore::MetricCount> &values) {
+        QFile stat("/proc/stat");
+        if (!stat.open(QIODevice::ReadOnly)) return false;
+        const QList<QByteArray> cpu = stat.readLine().simplified().split(' ');
+        quint64 total = 0, idle = 0;
+        for (int i = 1; i < cpu.size() && i <= 8; ++i) {
+            total += cpu[i].toULongLong();
+            if (i == 4 || i == 5) idle += cpu[i].toULongLong();
+        }
+        const bool first = lastTotal == 0;
+        const quint64 dTotal = total - lastTotal, dIdle = idle - lastIdle;
+        lastTotal = total;
+        lastIdle = idle;
+        if (first || dTotal == 0) return false;
+        values[MetricsStore::CpuLoad] = qint32(1000 * (dTotal - dIdle) / dTotal);
+
+        QFile meminfo("/proc/meminfo");
+        if (meminfo.open(QIODevice::ReadOnly)) {
+            qint64 memTotal = 0, memAvail = 0, swapTotal = 0, swapFree = 0;
+            for (const QByteArray &line : meminfo.readAll().split('\n')) {
+                const qint64 kb = line.mid(line.indexOf(':') + 1).trimmed().split(' ').first().toLongLong();
+                if (line.startsWith("MemTotal:")) memTotal = kb;
+                else if (line.startsWith("MemAvailable:")) memAvail = kb;
+                else if (line.startsWith("SwapTotal:")) swapTotal = kb;
+                else if (line.startsWith("SwapFree:")) swapFree = kb;
+            }
+            values[MetricsStore::MemoryUsed] = qint32((memTotal - memAvail) / 1024);
+            values[MetricsStore::SwapUsed] = qint32((swapTotal - swapFree) / 1024);
+        }
+
+        root.refresh();
+        if (root.isValid())
+            values[MetricsStore::RootUsed] = qint32((root.bytesTotal() - root.bytesFree()) / (1024 * 1024));
+
+        QFile loadavg("/proc/loadavg");
+        if (loadavg.open(QIODevice::ReadOnly))
+            values[MetricsStore::LoadAverage] = qRound(loadavg.readLine().split(' ').first().toDouble() * 100);
+        return true;
+    }
+
+    MetricsStore store;
+    QTimer timer;
+    bool writing = false;
+    QStorageInfo root = QStorageInfo::root();
+    std::array<Accumulator, MetricsStore::TierCount> pending;
+    quint64 lastTotal = 0;
+    quint64 lastIdle = 0;
+};
+
+class MetricsChart : public QWidget {
+public:
+    explicit MetricsChart(QWidget *parent = nullptr) : QWidget(parent) {
+        setMinimumHeight(150);
+        setAttribute(Qt::WA_OpaquePaintEvent);
+    }
+
+    void setSeries(QList<MetricsStore::Sample> series, MetricsStore::Metric shown, qint64 stepSeconds, qint64 spanSeconds) {
+        samples = std::move(series);
+        metric = shown;
+        step = stepSeconds;
+        span = spanSeconds;
+        update();
+    }
+
+    static QString format(MetricsStore::Metric metric, qint64 value) {
+        switch (metric) {
+        case MetricsStore::CpuLoad: return QString::number(value / 10.0, 'f', 1) + "%";
+        case MetricsStore::LoadAverage: return QString::number(value / 100.0, 'f', 2);
+        default: return formatBytes(qulonglong(value) * 1024 * 1024);
+        }
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter p(this);
+        p.fillRect(rect(), QColor("#0d0d0d"));
+        const QRectF plot = QRectF(rect()).adjusted(8, 8, -8, -24);
+        p.setPen(QColor("#2a3245"));
+        p.drawRect(plot);
+
+        const qint64 end = QDateTime::currentSecsSinceEpoch();
+        const qint64 start = end - span;
+        p.setPen(QColor("#9ca0b0"));
+        if (samples.isEmpty()) {
+            p.drawText(plot, Qt::AlignCenter, "No history recorded yet");
+            return;
+        }
+
+        qint64 lo = 0, hi = 1000;
+        if (metric != MetricsStore::CpuLoad) {
+            auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end(),
+                [this](const auto &a, const auto &b) { return a.values[metric] < b.values[metric]; });
+            lo = minIt->values[metric];
+            hi = maxIt->values[metric];
+            const qint64 pad = qMax<qint64>(1, (hi - lo) / 10);
+            lo = qMax<qint64>(0, lo - pad);
+            hi += pad;
+        }
+
+        QPainterPath path;
+        qint64 prevTime = 0;
+        for (const auto &s : samples) {
+            const QPointF pt(plot.left() + plot.width() * (s.time - start) / span,
+                             plot.bottom() - plot.height() * (s.values[metric] - lo) / double(hi - lo));
+            if (path.isEmpty() || s.time - prevTime > 2 * step) path.moveTo(pt);
+            else path.lineTo(pt);
+            prevTime = s.time;
+        }
+
+        p.drawText(plot.adjusted(4, 2, -4, -2), Qt::AlignTop | Qt::AlignLeft, format(metric, hi));
+        p.drawText(plot.adjusted(4, 2, -4, -2), Qt::AlignBottom | Qt::AlignLeft, format(metric, lo));
+        const QRectF axis(plot.left(), plot.bottom() + 4, plot.width(), 18);
+        const char *stamp = span > 2 * 86400 ? "dd MMM" : "dd MMM HH:mm";
+        p.drawText(axis, Qt::AlignLeft, QDateTime::fromSecsSinceEpoch(start).toString(stamp));
+        p.drawText(axis, Qt::AlignRight, "now: " + format(metric, samples.last().values[metric]));
+
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setClipRect(plot);
+        p.setPen(QPen(QColor("#00bfff"), 1.5));
+        p.drawPath(path);
+    }
+
+private:
+    QList<MetricsStore::Sample> samples;
+    MetricsStore::Metric metric = MetricsStore::CpuLoad;
+    qint64 step = 60;
+    qint64 span = 6 * 3600;
+};
+
+// Record layout returned by the getdents64 syscall, which glibc does not
+// declare.
+struct LinuxDirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+class DiskUsageScanner : public QObject {
+    Q_OBJECT
+public:
+    struct Entry {
+        QString name;
+        bool isDir = false;
+        qint64 bytes = 0;
+    };
+
+    struct FileHit {
+        QString path;
+        qint64 bytes = 0;
+    };
+
+    struct Snapshot {
+        QList<Entry> entries;
+        QList<FileHit> largest;
+        qint64 files = 0;
+        qint64 dirs = 0;
+        qint64 bytes = 0;
+        bool running = false;
+    };
+
+    explicit DiskUsageScanner(QObject *parent = nullptr) : QObject(parent) {}
+    ~DiskUsageScanner() override { cancel(); }
+
+    // Lists the root's children on the calling thread, then hands every
+    // subdirectory to a pool of workers that each own a deque: a worker
+    // pops its own newest task and steals the oldest from the others.
+    bool start(const QString &root) {
+        cancel();
+        stop = false;
+        ++generation;
+        files = 0;
+        dirs = 0;
+        total = 0;
+        pending = 0;
+        tops.clear();
+        topBytes.reset();
+        largest.clear();
+        largestFloor = 0;
+        for (auto &shard : inodes) shard.seen.clear();
+
+        const QByteArray rootPath = QFile::encodeName(QDir::cleanPath(root));
+        struct statx st;
+        if (::statx(AT_FDCWD, rootPath.constData(), 0, STATX_TYPE | STATX_MODE, &st) != 0 || !S_ISDIR(st.stx_mode))
+            return false;
+        devMajor = st.stx_dev_major;
+        devMinor = st.stx_dev_minor;
+
+        const int threadCount = qBound(2, QThread::idealThreadCount(), 16);
+        workers.clear();
+        for (int i = 0; i < threadCount; ++i) workers.push_back(std::make_unique<Worker>());
+
+        const int fd = ::openat(AT_FDCWD, rootPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return false;
+        std::vector<Task> seeds;
+        forEachEntry(fd, workers[0]->buffer, [&](const char *name, const struct statx &entry) {
+            Entry top;
+            top.name = QFile::decodeName(name);
+            top.isDir = S_ISDIR(entry.stx_mode);
+            const qsizetype index = tops.size();
+            tops.append(top);
+            if (top.isDir) {
+                if (sameDevice(entry))
+                    seeds.push_back({rootPath.toStdString() + (rootPath.endsWith('/') ? "" : "/") + name, int(index)});
+            } else {
+                countFile(entry, rootPath + (rootPath.endsWith('/') ? "" : "/") + name, int(index));
+            }
+        });
+        ::close(fd);
+
+        topBytes = std::make_unique<std::atomic<qint64>[]>(tops.size() + 1);
+        for (qsizetype i = 0; i < tops.size(); ++i) topBytes[i] = tops[i].bytes;
+        pending = qint64(seeds.size());
+        for (size_t i = 0; i < seeds.size(); ++i)
+            workers[i % workers.size()]->tasks.push_back(std::move(seeds[i]));
+
+        running = true;
+        if (seeds.empty()) {
+            finish(generation);
+            return true;
+        }
+        for (int i = 0; i < threadCount; ++i)
+            threads.emplace_back([this, i]() { run(i); });
+        return true;
+    }
+
+    void cancel() {
+        stop = true;
+        wake();
+        for (auto &t : threads) t.join();
+        threads.clear();
+        running = false;
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        s.files = files;
+        s.dirs = dirs;
+        s.bytes = total;
+        s.running = running;
+        for (qsizetype i = 0; i < tops.size(); ++i) {
+            Entry e = tops[i];
+            if (topBytes) e.bytes = topBytes[i];
+            s.entries.append(e);
+        }
+        std::sort(s.entries.begin(), s.entries.end(), [](const Entry &a, const Entry &b) { return a.bytes > b.bytes; });
+        std::lock_guard<std::mutex> guard(largestLock);
+        for (const auto &hit : largest) s.largest.append({QFile::decodeName(hit.second), hit.first});
+        return s;
+    }
+
+signals:
+    void finished();
+
+private:
+    struct Task {
+        std::string path;
+        int top = 0;
+    };
+
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::vector<char> buffer = std::vector<char>(64 * 1024);
+    };
+
+    struct InodeShard {
+        std::mutex lock;
+        std::unordered_set<quint64> seen;
+    };
+
+    bool sameDevice(const struct statx &st) const {
+        return st.stx_dev_major == devMajor && st.stx_dev_minor == devMinor;
+    }
+
+    template <typename Fn>
+    void forEachEntry(int fd, std::vector<char> &buffer, Fn &&fn) {
+        for (;;) {
+            const long n = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+            if (n <= 0) return;
+            for (long off = 0; off < n && !stop;) {
+                auto *d = reinterpret_cast<const LinuxDirent64 *>(buffer.data() + off);
+                off += d->d_reclen;
+                if (d->d_name[0] == '.' && (d->d_name[1] == '\0' || (d->d_name[1] == '.' && d->d_name[2] == '\0')))
+                    continue;
+                struct statx st;
+                if (::statx(fd, d->d_name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | AT_STATX_DONT_SYNC,
+                            STATX_TYPE | STATX_MODE | STATX_INO | STATX_NLINK | STATX_BLOCKS, &st) == 0)
+                    fn(d->d_name, st);
+            }
+        }
+    }
+
+    // Hard-linked files are charged once: the first worker to claim the
+    // inode counts it.
+    void countFile(const struct statx &st, const QByteArray &path, int top) {
+        if (st.stx_nlink > 1) {
+            InodeShard &shard = inodes[st.stx_ino % inodes.size()];
+            std::lock_guard<std::mutex> guard(shard.lock);
+            if (!shard.seen.insert(st.stx_ino).second) return;
+        }
+        const qint64 bytes = qint64(st.stx_blocks) * 512;
+        ++files;
+        total += bytes;
+        if (topBytes) topBytes[top] += bytes;
+        else tops[top].bytes += bytes;
+        if (bytes > largestFloor) recordLargest(path, bytes);
+    }
+
+    void recordLargest(const QByteArray &path, qint64 bytes) {
+        std::lock_guard<std::mutex> guard(largestLock);
+        largest.emplace(bytes, path);
+        if (largest.size() > 50) largest.erase(std::prev(largest.end()));
+        if (largest.size() == 50) largestFloor = std::prev(largest.end())->first;
+    }
+
+    bool next(int self, Task &task) {
+        {
+            Worker &own = *workers[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < workers.size(); ++i) {
+            Worker &victim = *workers[(self + i) % workers.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Bumps the posted count under the idle lock, so a worker that found
+    // nothing after reading the old count cannot miss the wake-up.
+    void wake() {
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            ++posted;
+        }
+        idle.notify_all();
+    }
+
+    // Workers with nothing to steal sleep until new tasks are posted or the
+    // last directory finishes.
+    void run(int self) {
+        const int gen = generation;
+        Task task;
+        while (!stop) {
+            const quint64 seen = posted;
+            if (!next(self, task)) {
+                std::unique_lock<std::mutex> guard(idleLock);
+                idle.wait(guard, [&]() { return stop || pending == 0 || posted != seen; });
+                if (pending == 0) break;
+                continue;
+            }
+            scanDirectory(self, task);
+            if (--pending == 0) {
+                wake();
+                QMetaObject::invokeMethod(this, [this, gen]() { finish(gen); }, Qt::QueuedConnection);
+                break;
+            }
+        }
+    }
+
+    void scanDirectory(int self, const Task &task) {
+        const int fd = ::openat(AT_FDCWD, task.path.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) return;
+        ++dirs;
+        qint64 local = 0;
+        std::vector<Task> found;
+        forEachEntry(fd, workers[self]->buffer, [&](const char *name, const struct statx &st) {
+            if (S_ISDIR(st.stx_mode)) {
+                local += qint64(st.stx_blocks) * 512;
+                if (sameDevice(st)) found.push_back({task.path + "/" + name, task.top});
+            } else {
+                countFile(st, QByteArray::fromStdString(task.path + "/" + name), task.top);
+            }
+        });
+        ::close(fd);
+        total += local;
+        topBytes[task.top] += local;
+        if (!found.empty()) {
+            pending += qint64(found.size());
+            Worker &own = *workers[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            for (auto &t : found) own.tasks.push_back(std::move(t));
+        }
+        if (!found.empty()) wake();
+    }
+
+    void finish(int gen) {
+        if (gen != generation) return;
+        for (auto &t : threads) t.join();
+        threads.clear();
+        running = false;
+        emit finished();
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::array<InodeShard, 64> inodes;
+    QList<Entry> tops;
+    std::unique_ptr<std::atomic<qint64>[]> topBytes;
+    mutable std::mutex largestLock;
+    std::multimap<qint64, QByteArray, std::greater<qint64>> largest;
+    std::atomic<qint64> largestFloor{0};
+    std::atomic<qint64> pending{0};
+    std::mutex idleLock;
+    std::condition_variable idle;
+    std::atomic<quint64> posted{0};
+    std::atomic<qint64> files{0};
+    std::atomic<qint64> dirs{0};
+    std::atomic<qint64> total{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> running{false};
+    std::atomic<int> generation{0};
+    quint32 devMajor = 0;
+    quint32 devMinor = 0;
+};
+
+class DiskUsageDialog : public QDialog {
+    Q_OBJECT
+public:
+    explicit DiskUsageDialog(const QString &root, QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowTitle("Disk Usage");
+        resize(760, 560);
+        auto layout = new QVBoxLayout(this);
+
+        auto pathRow = new QHBoxLayout;
+        auto upBtn = new QPushButton(QIcon::fromTheme("go-up"), "");
+        upBtn->setProperty("class", "plainButton");
+        pathEdit = new QLineEdit(root);
+        auto browseBtn = new QPushButton(QIcon::fromTheme("document-open-folder"), "Browse");
+        browseBtn->setProperty("class", "plainButton");
+        auto scanBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Scan");
+        scanBtn->setProperty("class", "plainButton");
+        pathRow->addWidget(upBtn);
+        pathRow->addWidget(pathEdit, 1);
+        pathRow->addWidget(browseBtn);
+        pathRow->addWidget(scanBtn);
+        layout->addLayout(pathRow);
+
+        statusLabel = new QLabel;
+        statusLabel->setProperty("class", "smallText");
+        layout->addWidget(statusLabel);
+
+        auto tabs = new QTabWidget;
+        entryTree = new QTreeWidget;
+        entryTree->setHeaderLabels({"Name", "Size", "Share"});
+        entryTree->setRootIsDecorated(false);
+        entryTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        tabs->addTab(entryTree, "By Directory");
+        largestTree = new QTreeWidget;
+        largestTree->setHeaderLabels({"File", "Size"});
+        largestTree->setRootIsDecorated(false);
+        largestTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        tabs->addTab(largestTree, "Largest Files");
+        layout->addWidget(tabs, 1);
+
+        auto hint = new QLabel("Double-click a directory to scan into it. The scan stays on one filesystem and counts hard links once.");
+        hint->setWordWrap(true);
+        hint->setProperty("class", "smallText");
+        layout->addWidget(hint);
+
+        connect(scanBtn, &QPushButton::clicked, this, [this]() { scan(pathEdit->text()); });
+        connect(pathEdit, &QLineEdit::returnPressed, this, [this]() { scan(pathEdit->text()); });
+        connect(upBtn, &QPushButton::clicked, this, [this]() {
+            QDir dir(pathEdit->text());
+            if (dir.cdUp()) scan(dir.absolutePath());
+        });
+        connect(browseBtn, &QPushButton::clicked, this, [this]() {
+            const QString dir = QFileDialog::getExistingDirectory(this, "Choose a directory", pathEdit->text());
+            if (!dir.isEmpty()) scan(dir);
+        });
+        connect(entryTree, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem *item) {
+            if (item->data(0, Qt::UserRole).toBool())
+                scan(QDir(pathEdit->text()).filePath(item->text(0)));
+        });
+        connect(&scanner, &DiskUsageScanner::finished, this, &DiskUsageDialog::showSnapshot);
+        connect(&poll, &QTimer::timeout, this, &DiskUsageDialog::showSnapshot);
+
+        QTimer::singleShot(0, this, [this, root]() { scan(root); });
+    }
+
+private slots:
+    void showSnapshot() {
+        const DiskUsageScanner::Snapshot s = scanner.snapshot();
+        if (!s.running) poll.stop();
+        statusLabel->setText(QString("%1 %2 in %3 files and %4 directories (%5 s)")
+            .arg(s.running ? "Scanning:" : "Done:", formatBytes(s.bytes)).arg(s.files).arg(s.dirs)
+            .arg(clock.elapsed() / 1000.0, 0, 'f', 1));
+
+        // Items are reused in place so the list does not flicker while the
+        // scan streams in.
+        const int shown = int(qMin<qsizetype>(s.entries.size(), 500));
+        while (entryTree->topLevelItemCount() > shown) delete entryTree->takeTopLevelItem(entryTree->topLevelItemCount() - 1);
+        for (int i = 0; i < shown; ++i) {
+            const auto &e = s.entries[i];
+            QTreeWidgetItem *item = i < entryTree->topLevelItemCount() ? entryTree->topLevelItem(i) : new QTreeWidgetItem(entryTree);
+            item->setText(0, e.name);
+            item->setIcon(0, QIcon::fromTheme(e.isDir ? "folder" : "text-x-generic"));
+            item->setData(0, Qt::UserRole, e.isDir);
+            item->setText(1, formatBytes(e.bytes));
+            item->setText(2, s.bytes > 0 ? QString::number(100.0 * e.bytes / s.bytes, 'f', 1) + "%" : QString());
+        }
+
+        while (largestTree->topLevelItemCount() > s.largest.size()) delete largestTree->takeTopLevelItem(largestTree->topLevelItemCount() - 1);
+        for (qsizetype i = 0; i < s.largest.size(); ++i) {
+            QTreeWidgetItem *item = i < largestTree->topLevelItemCount() ? largestTree->topLevelItem(i) : new QTreeWidgetItem(largestTree);
+            item->setText(0, s.largest[i].path);
+            item->setText(1, formatBytes(s.largest[i].bytes));
+        }
+    }
+
+private:
+    void scan(const QString &path) {
+        pathEdit->setText(QDir::cleanPath(path));
+        entryTree->clear();
+        largestTree->clear();
+        clock.start();
+        if (!scanner.start(pathEdit->text())) {
+            statusLabel->setText("Cannot read " + pathEdit->text());
+            return;
+        }
+        poll.start(250);
+        showSnapshot();
+    }
+
+    DiskUsageScanner scanner;
+    QLineEdit *pathEdit;
+    QLabel *statusLabel;
+    QTreeWidget *entryTree;
+    QTreeWidget *largestTree;
+    QTimer poll;
+    QElapsedTimer clock;
+};
 
-    int permanentPowerups = 0;
-};
 class SystemInfoPanel : public QWidget {
     Q_OBJECT
 public:
@@ -551,7 +2275,8 @@ public:
 
         auto leftLayout = new QVBoxLayout;
 
-        SystemInfoFetcher::Info sysInfo = SystemInfoFetcher::fetch();
+        const auto &snapshot = InventorySnapshot::cached();
+        SystemInfoFetcher::Info sysInfo = snapshot ? snapshot->info : SystemInfoFetcher::fetch();
 
         QString shortOS;
         if (sysInfo.osPretty.contains("<!>")) {
@@ -570,7 +2295,7 @@ public:
         leftLayout->addWidget(versionLabel);
 
         auto infoBox = new QGroupBox;
-        infoBox->setStyleSheet("QGroupBox { border: 1px solid #444; margin-top: 0; }");
+        infoBox->setProperty("class", "infoBox");
         auto infoLayout = new QVBoxLayout(infoBox);
 
         auto headerLayout = new QHBoxLayout;
@@ -579,15 +2304,13 @@ public:
         copyBtn = new QPushButton;
         copyBtn->setIcon(QIcon::fromTheme("edit-copy"));
         copyBtn->setFixedSize(24, 24);
-        copyBtn->setStyleSheet("QPushButton { background: transparent; border: none; opacity: 0.7; }"
-                               "QPushButton:hover { opacity: 1; background: rgba(255,255,255,0.1); border-radius: 4px; }");
+        copyBtn->setProperty("class", "iconButton");
         connect(copyBtn, &QPushButton::clicked, this, &SystemInfoPanel::copyAllInfo);
 
         refreshBtn = new QPushButton;
         refreshBtn->setIcon(QIcon::fromTheme("view-refresh"));
         refreshBtn->setFixedSize(24, 24);
-        refreshBtn->setStyleSheet("QPushButton { background: transparent; border: none; opacity: 0.7; }"
-                                  "QPushButton:hover { opacity: 1; background: rgba(255,255,255,0.1); border-radius: 4px; }");
+        refreshBtn->setProperty("class", "iconButton");
         connect(refreshBtn, &QPushButton::clicked, this, &SystemInfoPanel::refreshInfo);
 
         headerLayout->addWidget(copyBtn);
@@ -609,36 +2332,83 @@ public:
         infoData.append({"Time",        sysInfo.currentTime});
         infoData.append({"Install Date", sysInfo.installDate});
 
-        const QString labelStyle = "color: white; font-size: 13px; margin: 4px 0; font-family: 'Nimbus Mono';";
         for (auto& item : infoData) {
             auto label = new QLabel(item.key + ": " + item.value);
-            label->setStyleSheet(labelStyle);
+            label->setProperty("class", "infoText");
+            if (item.key == "Storage") {
+                label->setCursor(Qt::PointingHandCursor);
+                label->setToolTip("Show where the space went");
+                label->installEventFilter(this);
+                storageLabel = label;
+            }
             item.label = label;
             infoLayout->addWidget(label);
         }
 
         leftLayout->addWidget(infoBox);
+
+        auto historyBox = new QGroupBox("History");
+        auto historyLayout = new QVBoxLayout(historyBox);
+        auto historyControls = new QHBoxLayout;
+        metricCombo = new QComboBox;
+        metricCombo->addItem("CPU", MetricsStore::CpuLoad);
+        metricCombo->addItem("Memory", MetricsStore::MemoryUsed);
+        metricCombo->addItem("Swap", MetricsStore::SwapUsed);
+        metricCombo->addItem("Disk (/)", MetricsStore::RootUsed);
+        metricCombo->addItem("Load", MetricsStore::LoadAverage);
+        rangeCombo = new QComboBox;
+        rangeCombo->addItem("6 hours", 6 * 3600);
+        rangeCombo->addItem("24 hours", 24 * 3600);
+        rangeCombo->addItem("7 days", 7 * 86400);
+        rangeCombo->addItem("30 days", 30 * 86400);
+        rangeCombo->addItem("1 year", 365 * 86400);
+        historyControls->addWidget(metricCombo);
+        historyControls->addWidget(rangeCombo);
+        historyControls->addStretch();
+        historyLayout->addLayout(historyControls);
+        chart = new MetricsChart;
+        historyLayout->addWidget(chart);
+        leftLayout->addWidget(historyBox);
         leftLayout->addStretch();
 
+        connect(metricCombo, &QComboBox::currentIndexChanged, this, &SystemInfoPanel::reloadHistory);
+        connect(rangeCombo, &QComboBox::currentIndexChanged, this, &SystemInfoPanel::reloadHistory);
+        connect(&historyTimer, &QTimer::timeout, this, &SystemInfoPanel::reloadHistory);
+        historyTimer.start(60 * 1000);
+        reloadHistory();
+
         auto rightLayout = new QVBoxLayout;
         rightLayout->setAlignment(Qt::AlignCenter);
 
         auto iconLabel = new GlowingLogo;
-        auto pix = QPixmap(":/error.os.svgz").scaled(355, 440, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        iconLabel->setPixmap(pix);
+        iconLabel->setLogo(":/error.os.svgz", QSize(355, 440));
         iconLabel->setAlignment(Qt::AlignCenter);
-        iconLabel->setStyleSheet("background: transparent;");
         connect(iconLabel, &GlowingLogo::triggerMiniGame, this, &SystemInfoPanel::launchMiniGame);
         rightLayout->addWidget(iconLabel);
         rightLayout->addStretch();
 
         mainLayout->addLayout(leftLayout, 1);
         mainLayout->addLayout(rightLayout, 1);
+
+        reconcile();
+    }
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (watched == storageLabel && event->type() == QEvent::MouseButtonRelease) {
+            DiskUsageDialog dialog(QDir::homePath(), this);
+            dialog.exec();
+            return true;
+        }
+        return QWidget::eventFilter(watched, event);
     }
 
 private slots:
     void refreshInfo() {
-        SystemInfoFetcher::Info sysInfo = SystemInfoFetcher::fetch();
+        showInfo(SystemInfoFetcher::fetch());
+    }
+
+    void showInfo(const SystemInfoFetcher::Info &sysInfo) {
         for (auto& item : infoData) {
             if (item.key == "CPU Arch") item.label->setText(item.key + ": " + sysInfo.cpuArch);
             else if (item.key == "CPU Model") item.label->setText(item.key + ": " + sysInfo.cpuModel);
@@ -664,16 +2434,45 @@ private slots:
         }
         QGuiApplication::clipboard()->setText(info);
 
-        copyBtn->setStyleSheet("QPushButton { background: rgba(30,144,255,0.3); border: none; opacity: 1; }");
+        Theme::setState(copyBtn, "feedback", true);
         copyBtn->setToolTip("Copied!");
 
         QTimer::singleShot(800, [this]() {
-            copyBtn->setStyleSheet("QPushButton { background: transparent; border: none; opacity: 0.7; }"
-                                   "QPushButton:hover { opacity: 1; background: rgba(255,255,255,0.1); border-radius: 4px; }");
+            Theme::setState(copyBtn, "feedback", false);
             copyBtn->setToolTip("");
         });
     }
 
+    // The first paint uses the cached snapshot; live values replace it as
+    // soon as they are in, and the refreshed snapshot is written back.
+    void reconcile() {
+        auto watcher = new QFutureWatcher<SystemInfoFetcher::Info>(this);
+        connect(watcher, &QFutureWatcher<SystemInfoFetcher::Info>::finished, this, [this, watcher]() {
+            showInfo(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run([]() {
+            InventorySnapshot snapshot = InventorySnapshot::load().value_or(InventorySnapshot());
+            snapshot.refreshSystem();
+            if (snapshot.packagesStale()) snapshot.refreshPackages();
+            InventorySnapshot::update([&snapshot](InventorySnapshot &onDisk) {
+                snapshot.benchmarks = onDisk.benchmarks;
+                onDisk = snapshot;
+            });
+            return snapshot.info;
+        }));
+    }
+
+    // Spans up to a day read minutes, up to a month hours, beyond that days.
+    void reloadHistory() {
+        const qint64 span = rangeCombo->currentData().toLongLong();
+        const auto tier = span <= 86400 ? MetricsStore::Minute
+                        : span <= 30 * 86400 ? MetricsStore::Hour : MetricsStore::Day;
+        const auto metric = MetricsStore::Metric(metricCombo->currentData().toInt());
+        chart->setSeries(MetricsStore::read(tier, QDateTime::currentSecsSinceEpoch() - span),
+                         metric, MetricsStore::step(tier), span);
+    }
+
     void launchMiniGame() {
         MiniGameDialog game(this);
         game.exec();
@@ -688,12 +2487,199 @@ private:
     QList<InfoItem> infoData;
     QPushButton *copyBtn = nullptr;
     QPushButton *refreshBtn = nullptr;
+    QLabel *storageLabel = nullptr;
+    QComboBox *metricCombo = nullptr;
+    QComboBox *rangeCombo = nullptr;
+    MetricsChart *chart = nullptr;
+    MetricsSampler sampler;
+    QTimer historyTimer;
 };
 
-class DriverManager : public QWidget {
-    Q_OBJECT
+class AptPlanner {
 public:
-    DriverManager(QWidget *parent = nullptr) : QWidget(parent) {
+    struct Change {
+        enum Action { Install, Upgrade, Remove } action = Install;
+        QString package;
+        QString version;
+        qint64 downloadBytes = 0;
+        qint64 installedDelta = 0;
+    };
+
+    struct Plan {
+        QList<Change> changes;
+        QStringList problems;
+        qint64 downloadBytes = 0;
+        qint64 installedDelta = 0;
+    };
+
+    // apt-get -s resolves the whole selection without root; sizes come
+    // from the candidate records and the installed ones from dpkg.
+    static Plan plan(const QStringList &packages) {
+        Plan p;
+        QProcess sim;
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("LC_ALL", "C");
+        sim.setProcessEnvironment(env);
+        sim.start("apt-get", QStringList{"-s", "-q", "install"} + packages);
+        if (!sim.waitForFinished(60000)) {
+            p.problems << "apt-get did not finish the simulation.";
+            return p;
+        }
+
+        static const QRegularExpression inst("^Inst (\\S+) (?:\\[(\\S+)\\] )?\\((\\S+)");
+        static const QRegularExpression remv("^Remv (\\S+)");
+        for (const QString &line : QString::fromUtf8(sim.readAllStandardOutput()).split('\n')) {
+            if (auto m = inst.match(line); m.hasMatch()) {
+                p.changes << Change{m.captured(2).isEmpty() ? Change::Install : Change::Upgrade, m.captured(1), m.captured(3)};
+            } else if (auto r = remv.match(line); r.hasMatch()) {
+                p.changes << Change{Change::Remove, r.captured(1)};
+            } else if (line.contains("but it is not going to be installed") || line.contains("Conflicts:") || line.contains("Breaks:")) {
+                p.problems << line.trimmed();
+            }
+        }
+        for (const QString &line : QString::fromUtf8(sim.readAllStandardError()).split('\n'))
+            if (line.startsWith("E:")) p.problems << line.mid(2).trimmed();
+        if (sim.exitCode() != 0 && p.problems.isEmpty()) p.problems << "apt-get could not resolve the selection.";
+
+        QStringList incoming, installed;
+        for (const Change &c : std::as_const(p.changes)) {
+            if (c.action != Change::Remove) incoming << c.package;
+            if (c.action != Change::Install) installed << c.package;
+        }
+        const QMap<QString, QPair<qint64, qint64>> candidates = candidateSizes(incoming);
+        const QMap<QString, qint64> current = installedSizes(installed);
+        for (Change &c : p.changes) {
+            const auto sizes = candidates.value(c.package);
+            if (c.action != Change::Remove) c.downloadBytes = sizes.first;
+            c.installedDelta = (c.action != Change::Remove ? sizes.second : 0) - current.value(c.package);
+            p.downloadBytes += c.downloadBytes;
+            p.installedDelta += c.installedDelta;
+        }
+        return p;
+    }
+
+private:
+    static QMap<QString, QPair<qint64, qint64>> candidateSizes(const QStringList &packages) {
+        QMap<QString, QPair<qint64, qint64>> out;
+        if (packages.isEmpty()) return out;
+        QProcess show;
+        show.start("apt-cache", QStringList{"show", "--no-all-versions"} + packages);
+        show.waitForFinished(60000);
+        QString name;
+        for (const QString &line : QString::fromUtf8(show.readAllStandardOutput()).split('\n')) {
+            if (line.startsWith("Package: ")) name = line.mid(9).trimmed();
+            else if (line.startsWith("Size: ")) out[name].first = line.mid(6).toLongLong();
+            else if (line.startsWith("Installed-Size: ")) out[name].second = line.mid(16).toLongLong() * 1024;
+        }
+        return out;
+    }
+
+    static QMap<QString, qint64> installedSizes(const QStringList &packages) {
+        QMap<QString, qint64> out;
+        if (packages.isEmpty()) return out;
+        QProcess query;
+        query.start("dpkg-query", QStringList{"-W", "-f=${Package} ${Installed-Size}\\n"} + packages);
+        query.waitForFinished(30000);
+        for (const QString &line : QString::fromUtf8(query.readAllStandardOutput()).split('\n', Qt::SkipEmptyParts))
+            out.insert(line.section(' ', 0, 0).section(':', 0, 0), line.section(' ', 1, 1).toLongLong() * 1024);
+        return out;
+    }
+};
+
+class AptPlanDialog : public QDialog {
+    Q_OBJECT
+public:
+    AptPlanDialog(const QStringList &packages, QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowTitle("Install Plan");
+        resize(640, 460);
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Install Plan");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        summaryLabel = new QLabel("Resolving " + packages.join(", ") + "...");
+        summaryLabel->setWordWrap(true);
+        layout->addWidget(summaryLabel);
+
+        changeTree = new QTreeWidget;
+        changeTree->setHeaderLabels({"Package", "Action", "Version", "Download", "Disk"});
+        changeTree->setRootIsDecorated(false);
+        changeTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(changeTree, 1);
+
+        problemLabel = new QLabel;
+        problemLabel->setWordWrap(true);
+        problemLabel->hide();
+        Theme::setState(problemLabel, "warning", true);
+        layout->addWidget(problemLabel);
+
+        auto buttons = new QHBoxLayout;
+        auto cancelBtn = new QPushButton("Cancel");
+        cancelBtn->setProperty("class", "plainButton");
+        proceedBtn = new QPushButton(QIcon::fromTheme("dialog-ok"), "Install");
+        proceedBtn->setProperty("class", "plainButton");
+        proceedBtn->setEnabled(false);
+        buttons->addStretch();
+        buttons->addWidget(cancelBtn);
+        buttons->addWidget(proceedBtn);
+        layout->addLayout(buttons);
+
+        connect(cancelBtn, &QPushButton::clicked, this, &QDialog::reject);
+        connect(proceedBtn, &QPushButton::clicked, this, &QDialog::accept);
+
+        auto watcher = new QFutureWatcher<AptPlanner::Plan>(this);
+        connect(watcher, &QFutureWatcher<AptPlanner::Plan>::finished, this, [this, watcher]() {
+            showPlan(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run(AptPlanner::plan, packages));
+    }
+
+    // Returns true when the user accepts the resolved plan.
+    static bool confirm(const QStringList &packages, QWidget *parent) {
+        AptPlanDialog dialog(packages, parent);
+        return dialog.exec() == QDialog::Accepted;
+    }
+
+private:
+    void showPlan(const AptPlanner::Plan &plan) {
+        static const char *actions[] = {"install", "upgrade", "remove"};
+        int counts[3] = {};
+        for (const auto &c : plan.changes) {
+            ++counts[c.action];
+            auto item = new QTreeWidgetItem(changeTree);
+            item->setText(0, c.package);
+            item->setText(1, actions[c.action]);
+            item->setText(2, c.version);
+            item->setText(3, c.downloadBytes > 0 ? formatBytes(qulonglong(c.downloadBytes)) : QString());
+            item->setText(4, signedBytes(c.installedDelta));
+        }
+        summaryLabel->setText(QString("%1 new, %2 upgraded, %3 removed. Download %4, disk usage %5.")
+                                  .arg(counts[0]).arg(counts[1]).arg(counts[2])
+                                  .arg(formatBytes(qulonglong(plan.downloadBytes)), signedBytes(plan.installedDelta)));
+        if (!plan.problems.isEmpty()) {
+            problemLabel->setText(plan.problems.join('\n'));
+            problemLabel->show();
+        }
+        proceedBtn->setEnabled(plan.problems.isEmpty());
+        if (counts[2] > 0) proceedBtn->setText("Install and Remove");
+    }
+
+    static QString signedBytes(qint64 bytes) {
+        return (bytes < 0 ? "-" : "+") + formatBytes(qulonglong(qAbs(bytes)));
+    }
+
+    QLabel *summaryLabel;
+    QTreeWidget *changeTree;
+    QLabel *problemLabel;
+    QPushButton *proceedBtn;
+};
+
+class DriverManager : public QWidget {
+    Q_OBJECT
+public:
+    DriverManager(QWidget *parent = nullptr) : QWidget(parent) {
         QVBoxLayout *layout = new QVBoxLayout(this);
         layout->setContentsMargins(20, 20, 20, 20);
         layout->setSpacing(20);
@@ -774,28 +2760,8 @@ public:
 
 private slots:
     void detectHardware() {
-        QString gpuVendor, cpuVendor;
-
-        {
-            QProcess p;
-            p.start("sh", {"-c", "lspci | grep -i 'vga\\|3d' "});
-            p.waitForFinished();
-            QString out = p.readAllStandardOutput().toLower();
-            if (out.contains("nvidia")) gpuVendor = "nvidia";
-            else if (out.contains("amd") || out.contains("ati")) gpuVendor = "amd";
-            else if (out.contains("intel")) gpuVendor = "intel";
-            else gpuVendor = "unknown";
-        }
-
-        {
-            QProcess p;
-            p.start("sh", {"-c", "lscpu | grep 'Vendor ID'"});
-            p.waitForFinished();
-            QString out = p.readAllStandardOutput().toLower();
-            if (out.contains("authenticamd")) cpuVendor = "amd";
-            else if (out.contains("genuineintel")) cpuVendor = "intel";
-            else cpuVendor = "unknown";
-        }
+        const QString gpuVendor = HardwareDetector::gpuVendor();
+        const QString cpuVendor = HardwareDetector::cpuVendor();
 
         statusLabel->setText(QString("Detected GPU: %1 | CPU: %2").arg(gpuVendor, cpuVendor));
 
@@ -824,6 +2790,7 @@ private slots:
     }
 
     void installNvidiaDriver() {
+        if (!AptPlanDialog::confirm({"nvidia-driver", "nvidia-settings"}, this)) return;
         runInTerminal("apt install -y nvidia-driver nvidia-settings", this,
                       "Installing NVIDIA driver...");
     }
@@ -859,6 +2826,157 @@ private:
     QGroupBox *removalGroup;
     QVBoxLayout *removalLayout;
 };
+class FlatpakBackend {
+public:
+    static bool available() { return !QStandardPaths::findExecutable("flatpak").isEmpty(); }
+
+    static QString flathubUrl() { return "https://dl.flathub.org/repo/flathub.flatpakrepo"; }
+
+    static QStringList query(const QStringList &args) {
+        QProcess p;
+        p.start("flatpak", args);
+        if (!p.waitForFinished(15000)) return {};
+        QStringList out;
+        for (const QString &line : QString::fromUtf8(p.readAllStandardOutput()).split('\n', Qt::SkipEmptyParts))
+            out << line.trimmed();
+        return out;
+    }
+
+    static QSet<QString> installedApps() {
+        const QStringList ids = query({"list", "--app", "--columns=application"});
+        return QSet<QString>(ids.begin(), ids.end());
+    }
+
+    // Without flatpak everything has to happen as root in one script, so
+    // the remote is only added once the package is in place.
+    static QString bootstrapScript(const QStringList &apps) {
+        return QString("set -e\napt-get update\napt-get install -y flatpak\n"
+                       "flatpak remote-add --if-not-exists flathub %1\n"
+                       "flatpak install -y --noninteractive flathub %2\n").arg(flathubUrl(), apps.join(' '));
+    }
+};
+
+class FlatpakInstallDialog : public QDialog {
+    Q_OBJECT
+public:
+    // All apps go into one transaction, so flatpak resolves and downloads
+    // each shared runtime once.
+    FlatpakInstallDialog(const QStringList &apps, QWidget *parent = nullptr) : QDialog(parent), apps(apps) {
+        setWindowTitle("Installing Flatpak Apps");
+        resize(620, 440);
+        auto layout = new QVBoxLayout(this);
+
+        statusLabel = new QLabel("Preparing the Flathub remote...");
+        layout->addWidget(statusLabel);
+
+        overall = new QProgressBar;
+        overall->setRange(0, 0);
+        layout->addWidget(overall);
+
+        refTree = new QTreeWidget;
+        refTree->setHeaderLabels({"Ref", "Progress"});
+        refTree->setRootIsDecorated(false);
+        refTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(refTree, 1);
+
+        closeBtn = new QPushButton("Cancel");
+        closeBtn->setProperty("class", "plainButton");
+        layout->addWidget(closeBtn);
+        connect(closeBtn, &QPushButton::clicked, this, [this]() {
+            if (process.state() != QProcess::NotRunning) process.terminate();
+            else accept();
+        });
+
+        process.setProcessChannelMode(QProcess::MergedChannels);
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("LC_ALL", "C");
+        process.setProcessEnvironment(env);
+        connect(&process, &QProcess::readyRead, this, &FlatpakInstallDialog::readOutput);
+        connect(&process, &QProcess::finished, this, &FlatpakInstallDialog::stepFinished);
+        process.start("flatpak", {"remote-add", "--user", "--if-not-exists", "flathub", FlatpakBackend::flathubUrl()});
+    }
+
+    ~FlatpakInstallDialog() override {
+        if (process.state() != QProcess::NotRunning) {
+            process.kill();
+            process.waitForFinished(1000);
+        }
+    }
+
+private slots:
+    void stepFinished(int exitCode, QProcess::ExitStatus status) {
+        if (!installing && exitCode == 0 && status == QProcess::NormalExit) {
+            installing = true;
+            statusLabel->setText(QString("Installing %1 app(s)...").arg(apps.size()));
+            process.start("flatpak", QStringList{"install", "--user", "-y", "--noninteractive", "flathub"} + apps);
+            return;
+        }
+        const bool ok = exitCode == 0 && status == QProcess::NormalExit;
+        overall->setRange(0, 1);
+        overall->setValue(ok ? 1 : 0);
+        statusLabel->setText(ok ? "All apps installed." : "Flatpak failed: " + lastLine);
+        Theme::setState(statusLabel, "warning", !ok);
+        closeBtn->setText("Close");
+    }
+
+    // flatpak writes "Installing 2/5…" ahead of each operation and the
+    // percentage on the same line; the summary table maps numbers to refs.
+    // A transaction with a single operation prints plain "Installing…".
+    void readOutput() {
+        static const QRegularExpression tableRow("^\\s*(\\d+)\\.\\s+(?:\\[(.)\\]\\s+)?(\\S+)");
+        static const QRegularExpression operation("^(?:Installing|Updating)(?:\\s+(\\d+)/(\\d+)|…|\\.\\.\\.)");
+        static const QRegularExpression percent("(\\d+)%");
+        buffer += QString::fromUtf8(process.readAll());
+        const QStringList lines = buffer.split(QRegularExpression("[\\r\\n]"));
+        buffer = lines.last();
+        for (qsizetype i = 0; i + 1 < lines.size(); ++i) {
+            const QString line = lines[i].trimmed();
+            if (line.isEmpty()) continue;
+            lastLine = line;
+            if (auto m = tableRow.match(line); m.hasMatch()) {
+                QTreeWidgetItem *item = row(m.captured(1).toInt());
+                item->setText(0, m.captured(3));
+                if (!m.captured(2).isEmpty() && m.captured(2) != " ") item->setText(1, "done");
+                continue;
+            }
+            if (auto m = operation.match(line); m.hasMatch()) {
+                const bool counted = m.hasCaptured(1);
+                const int number = counted ? m.captured(1).toInt() : 1;
+                if (current > 0 && current != number) row(current)->setText(1, "done");
+                current = number;
+                overall->setRange(0, (counted ? m.captured(2).toInt() : 1) * 100);
+            }
+            if (current > 0) {
+                const auto p = percent.match(line);
+                const int value = p.hasMatch() ? p.captured(1).toInt() : 0;
+                row(current)->setText(1, QString("%1%").arg(value));
+                overall->setValue((current - 1) * 100 + value);
+            }
+        }
+    }
+
+private:
+    QTreeWidgetItem *row(int number) {
+        while (refTree->topLevelItemCount() < number) {
+            auto item = new QTreeWidgetItem(refTree);
+            item->setText(0, QString("Operation %1").arg(refTree->topLevelItemCount()));
+            item->setText(1, "waiting");
+        }
+        return refTree->topLevelItem(number - 1);
+    }
+
+    QStringList apps;
+    QProcess process;
+    QLabel *statusLabel;
+    QProgressBar *overall;
+    QTreeWidget *refTree;
+    QPushButton *closeBtn;
+    QString buffer;
+    QString lastLine;
+    int current = 0;
+    bool installing = false;
+};
+
 class AppInstaller : public QWidget {
     Q_OBJECT
 public:
@@ -939,6 +3057,7 @@ private:
                     pkgs << item->data(Qt::UserRole).toString();
             }
             if (pkgs.isEmpty()) { status->setText("No apps selected."); return; }
+            if (!AptPlanDialog::confirm(pkgs, this)) { status->setText("Install cancelled."); return; }
             status->setText("Installing via APT...");
             runInTerminal("apt install -y " + pkgs.join(' '), this, "Installing apps...");
         });
@@ -973,7 +3092,7 @@ private:
         btn->setProperty("class", "plainButton");
         vbox->addWidget(btn);
 
-        connect(btn, &QPushButton::clicked, this, [this, list, status]() {
+        connect(btn, &QPushButton::clicked, this, [this, btn, list, status]() {
             QStringList pkgs;
             for (int i=0;i<list->count();++i) {
                 auto item = list->item(i);
@@ -982,20 +3101,30 @@ private:
             }
             if (pkgs.isEmpty()) { status->setText("No apps selected."); return; }
 
-            QProcess check;
-            check.start("which", {"flatpak"});
-            check.waitForFinished();
-            bool hasFlatpak = !check.readAllStandardOutput().trimmed().isEmpty();
-            if (!hasFlatpak) {
-                status->setText("Flatpak not found. Installing...");
-                runInTerminal("apt update && apt install -y flatpak && "
-                              "flatpak remote-add --if-not-exists flathub https://flathub.org/repo/flathub.flatpakrepo",
-                              this, "Installing Flatpak...");
+            if (!FlatpakBackend::available()) {
+                status->setText("Flatpak not found. Installing it and the selected apps...");
+                runScriptInTerminal(FlatpakBackend::bootstrapScript(pkgs), this, "Installing Flatpak...");
+                return;
             }
 
-            QString cmd = "flatpak install -y " + pkgs.join(' ');
-            status->setText("Installing selected Flatpak apps...");
-            runInTerminal(cmd, this, "Installing Flatpak apps...");
+            btn->setEnabled(false);
+            status->setText("Checking installed Flatpak apps...");
+            auto watcher = new QFutureWatcher<QSet<QString>>(this);
+            connect(watcher, &QFutureWatcher<QSet<QString>>::finished, this, [this, watcher, btn, status, pkgs]() mutable {
+                const QSet<QString> installed = watcher->result();
+                watcher->deleteLater();
+                btn->setEnabled(true);
+                pkgs.erase(std::remove_if(pkgs.begin(), pkgs.end(), [&installed](const QString &id) {
+                    return installed.contains(id);
+                }), pkgs.end());
+                if (pkgs.isEmpty()) { status->setText("The selected apps are already installed."); return; }
+
+                status->setText("Installing selected Flatpak apps...");
+                FlatpakInstallDialog dialog(pkgs, this);
+                dialog.exec();
+                status->setText("Select applications to install:");
+            });
+            watcher->setFuture(QtConcurrent::run(&FlatpakBackend::installedApps));
         });
 
         return widget;
@@ -1201,7 +3330,9 @@ public:
         inputEdit = new QLineEdit();
         inputEdit->setPlaceholderText("Package name");
 
-        QStringList installedPkgs = getInstalledPackages();
+        const auto &snapshot = InventorySnapshot::cached();
+        QStringList installedPkgs = snapshot && !snapshot->packagesStale()
+            ? snapshot->packageNames() : PackageIndex::names();
         QCompleter *completer = new QCompleter(installedPkgs, this);
         completer->setCaseSensitivity(Qt::CaseInsensitive);
         inputEdit->setCompleter(completer);
@@ -1219,22 +3350,6 @@ private:
     QLineEdit *inputEdit;
     QPushButton *removeBtn;
 
-    QStringList getInstalledPackages() {
-        QStringList pkgs;
-        QProcess proc;
-        proc.start("dpkg-query", {"-f=${Status} ${Package}\\n", "-W"});
-        proc.waitForFinished(3000);
-        QString out = proc.readAllStandardOutput();
-
-        for (const QString &line : out.split('\n', Qt::SkipEmptyParts)) {
-            if (line.startsWith("install ok installed")) {
-                QString pkg = line.section(' ', 3);
-                pkgs << pkg.trimmed();
-            }
-        }
-        return pkgs;
-    }
-
 private slots:
     void removeAppByName() {
         QString pkg = inputEdit->text().trimmed();
@@ -1248,424 +3363,4353 @@ private slots:
     }
 };
 
-class WineOptimizerDialog : public QDialog {
-    Q_OBJECT
+class WineRegistry {
 public:
-    WineOptimizerDialog(QWidget *parent = nullptr) : QDialog(parent) {
-        setWindowTitle("Wine Configuration & Optimizer");
-        setWindowIcon(QIcon::fromTheme("winecfg"));
-        setMinimumSize(700, 650);
-        resize(700, 650);
+    enum Hive { UserHive, SystemHive };
 
-        auto mainLayout = new QVBoxLayout(this);
+    // An invalid value deletes the entry.
+    struct Edit {
+        Hive hive;
+        QString key;
+        QString name;
+        QVariant value;
+    };
 
-        auto titleLabel = new QLabel("Wine Optimizer & Configurator");
+    static QString defaultPrefix() {
+        QString env = qEnvironmentVariable("WINEPREFIX");
+        return env.isEmpty() ? QDir::homePath() + "/.wine" : env;
+    }
 
-        titleLabel->setProperty("class", "titleText");
-        mainLayout->addWidget(titleLabel);
+    static QString hivePath(const QString &prefix, Hive hive) {
+        return QDir(prefix).filePath(hive == UserHive ? "user.reg" : "system.reg");
+    }
 
+    static QString rootName(Hive hive) {
+        return hive == UserHive ? "HKCU" : "HKLM";
+    }
 
-        statusLabel = new QLabel("Checking Wine installation...");
-        mainLayout->addWidget(statusLabel);
+    // wineserver holds an fcntl lock on /tmp/.wine-<uid>/server-<dev>-<ino>/lock
+    // for as long as it serves the prefix, and rewrites the hives on exit.
+    static bool isPrefixLocked(const QString &prefix) {
+        struct stat st;
+        if (::stat(QFile::encodeName(prefix).constData(), &st) != 0) return false;
+
+        QString lockPath = QString("/tmp/.wine-%1/server-%2-%3/lock")
+                               .arg(::getuid())
+                               .arg(qulonglong(st.st_dev), 0, 16)
+                               .arg(qulonglong(st.st_ino), 0, 16);
+        int fd = ::open(QFile::encodeName(lockPath).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct flock fl = {};
+        fl.l_type = F_WRLCK;
+        fl.l_whence = SEEK_SET;
+        bool locked = ::fcntl(fd, F_GETLK, &fl) == 0 && fl.l_type != F_UNLCK;
+        ::close(fd);
+        return locked;
+    }
 
-        auto tabs = new QTabWidget;
-        tabs->addTab(makeScrollable(createInstallTab()), QIcon::fromTheme("system-software-install"), "Install/Update");
-        tabs->addTab(makeScrollable(createOptimizeTab()), QIcon::fromTheme("preferences-system-performance"), "Optimize");
-        tabs->addTab(makeScrollable(createConfigTab()), QIcon::fromTheme("preferences-system"), "Configure");
-        tabs->addTab(makeScrollable(createCleanupTab()), QIcon::fromTheme("edit-clear-all"), "Cleanup");
+    static QStringList apply(const QString &prefix, const QList<Edit> &edits) {
+        QStringList log;
+        if (isPrefixLocked(prefix)) {
+            log << QString("  wineserver is running for %1, writing through wine reg").arg(prefix);
+            QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+            env.insert("WINEPREFIX", prefix);
+            for (const Edit &e : edits) {
+                const bool isString = e.value.typeId() == QMetaType::QString;
+                QProcess p;
+                p.setProcessEnvironment(env);
+                if (!e.value.isValid())
+                    p.start("wine", {"reg", "delete", rootName(e.hive) + "\\" + e.key, "/v", e.name, "/f"});
+                else
+                    p.start("wine", {"reg", "add", rootName(e.hive) + "\\" + e.key, "/v", e.name,
+                                     "/t", isString ? "REG_SZ" : "REG_DWORD",
+                                     "/d", isString ? e.value.toString() : QString::number(e.value.toUInt()),
+                                     "/f"});
+                p.waitForFinished(15000);
+            }
+            return log;
+        }
 
-        logArea = new QTextEdit;
-        logArea->setReadOnly(true);
-        logArea->setMaximumHeight(150);
+        for (Hive hive : {UserHive, SystemHive}) {
+            WineRegistry reg;
+            int count = 0;
+            for (const Edit &e : edits) {
+                if (e.hive != hive) continue;
+                if (count == 0 && !reg.load(hivePath(prefix, hive))) {
+                    log << QString("  Cannot read %1 (run wineboot to initialise the prefix)").arg(hivePath(prefix, hive));
+                    break;
+                }
+                if (e.value.isValid()) reg.setValue(e.key, e.name, e.value);
+                else reg.removeValue(e.key, e.name);
+                ++count;
+            }
+            if (count == 0) continue;
+            if (reg.save())
+                log << QString("  %1: %2 value(s) written").arg(QFileInfo(reg.path()).fileName()).arg(count);
+            else
+                log << QString("  Failed to write %1").arg(reg.path());
+        }
+        return log;
+    }
 
-        auto closeBtn = new QPushButton(QIcon::fromTheme("window-close"), "Close");
-        connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+    bool load(const QString &path) {
+        filePath = path;
+        preamble.clear();
+        sections.clear();
+        sectionIndex.clear();
+
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) return false;
+
+        const QList<QByteArray> lines = f.readAll().split('\n');
+        Section *current = nullptr;
+        QString pending;
+        for (const QByteArray &raw : lines) {
+            QString line = QString::fromUtf8(raw);
+            if (!pending.isEmpty()) {
+                pending += '\n';
+                pending += line;
+                if (line.endsWith('\\')) continue;
+                current->entries << pending;
+                pending.clear();
+                continue;
+            }
+            if (line.startsWith('[')) {
+                int close = line.lastIndexOf(']');
+                Section s;
+                s.key = unescapeKey(line.mid(1, close > 0 ? close - 1 : -1));
+                s.header = line;
+                sections.append(s);
+                sectionIndex.insert(s.key.toLower(), sections.size() - 1);
+                current = &sections.last();
+                continue;
+            }
+            if (!current) {
+                preamble << line;
+            } else if (line.endsWith('\\')) {
+                pending = line;
+            } else {
+                current->entries << line;
+            }
+        }
+        if (!pending.isEmpty() && current) current->entries << pending;
+        return true;
+    }
 
-        mainLayout->addWidget(tabs, 1);
-        mainLayout->addWidget(logArea);
-        mainLayout->addWidget(closeBtn);
+    bool save() {
+        QStringList out = preamble;
+        for (const Section &s : std::as_const(sections)) {
+            out << s.header;
+            out << s.entries;
+        }
+        QSaveFile f(filePath);
+        if (!f.open(QIODevice::WriteOnly)) return false;
+        f.write(out.join('\n').toUtf8());
+        return f.commit();
+    }
 
-        checkWineInstallation();
+    QString path() const { return filePath; }
+
+    // REG_DWORD values come back as uint, REG_SZ as QString, anything else is invalid.
+    QVariant value(const QString &key, const QString &name) const {
+        auto it = sectionIndex.constFind(key.toLower());
+        if (it == sectionIndex.constEnd()) return {};
+        for (const QString &entry : sections.at(*it).entries) {
+            QString entryName, data;
+            if (!parseEntry(entry, &entryName, &data) || entryName.compare(name, Qt::CaseInsensitive) != 0)
+                continue;
+            if (data.startsWith("dword:")) {
+                bool ok;
+                uint v = data.mid(6).toUInt(&ok, 16);
+                return ok ? QVariant(v) : QVariant();
+            }
+            if (data.startsWith('"') && data.endsWith('"'))
+                return unescapeString(data.mid(1, data.size() - 2));
+            return {};
+        }
+        return {};
+    }
+
+    void setValue(const QString &key, const QString &name, const QVariant &value) {
+        QString data = value.typeId() == QMetaType::QString
+                           ? QString("\"%1\"").arg(escapeString(value.toString()))
+                           : QString("dword:%1").arg(value.toUInt(), 8, 16, QChar('0'));
+        QString line = (name == "@" ? QString("@") : QString("\"%1\"").arg(escapeString(name))) + "=" + data;
+
+        Section &s = section(key);
+        touch(s);
+        int lastEntry = -1;
+        for (int i = 0; i < s.entries.size(); ++i) {
+            QString entryName;
+            if (parseEntry(s.entries.at(i), &entryName, nullptr) && entryName.compare(name, Qt::CaseInsensitive) == 0) {
+                s.entries[i] = line;
+                return;
+            }
+            if (!s.entries.at(i).isEmpty()) lastEntry = i;
+        }
+        s.entries.insert(lastEntry + 1, line);
+    }
+
+    void removeValue(const QString &key, const QString &name) {
+        auto it = sectionIndex.constFind(key.toLower());
+        if (it == sectionIndex.constEnd()) return;
+        Section &s = sections[*it];
+        for (int i = 0; i < s.entries.size(); ++i) {
+            QString entryName;
+            if (parseEntry(s.entries.at(i), &entryName, nullptr) && entryName.compare(name, Qt::CaseInsensitive) == 0) {
+                s.entries.removeAt(i);
+                touch(s);
+                return;
+            }
+        }
     }
 
 private:
-    QWidget* makeScrollable(QWidget *content) {
-        QScrollArea *scroll = new QScrollArea;
-        scroll->setWidgetResizable(true);
-        scroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-        scroll->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-        scroll->setWidget(content);
-        scroll->setFrameShape(QFrame::NoFrame);
-        return scroll;
+    struct Section {
+        QString key;
+        QString header;
+        QStringList entries;
+    };
+
+    Section &section(const QString &key) {
+        auto it = sectionIndex.constFind(key.toLower());
+        if (it != sectionIndex.constEnd()) return sections[*it];
+
+        if (!sections.isEmpty() && !sections.last().entries.isEmpty() && !sections.last().entries.last().isEmpty())
+            sections.last().entries << QString();
+        Section s;
+        s.key = key;
+        s.entries << QString();
+        sections.append(s);
+        sectionIndex.insert(key.toLower(), sections.size() - 1);
+        return sections.last();
     }
 
-    QWidget* createInstallTab() {
-        auto widget = new QWidget;
-        auto layout = new QVBoxLayout(widget);
+    static void touch(Section &s) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        QString escaped = s.key;
+        s.header = QString("[%1] %2").arg(escaped.replace("\\", "\\\\")).arg(now);
 
-        auto infoLabel = new QLabel(
-            "Wine allows you to run Windows applications on Linux.\n"
-            "Install or update Wine to the latest version."
-            );
-        infoLabel->setWordWrap(true);
-        layout->addWidget(infoLabel);
+        const QString time = QString("#time=%1").arg(qulonglong(now + 11644473600LL) * 10000000ULL, 0, 16);
+        for (QString &entry : s.entries) {
+            if (entry.startsWith("#time=")) { entry = time; return; }
+        }
+        s.entries.prepend(time);
+    }
 
-        wineVersionLabel = new QLabel("Wine Version: Checking...");
-        layout->addWidget(wineVersionLabel);
+    static bool parseEntry(const QString &entry, QString *name, QString *data) {
+        int valueStart = -1;
+        QString parsed;
+        if (entry.startsWith("@=")) {
+            parsed = "@";
+            valueStart = 2;
+        } else if (entry.startsWith('"')) {
+            for (int i = 1; i < entry.size(); ++i) {
+                QChar c = entry.at(i);
+                if (c == '\\' && i + 1 < entry.size()) { parsed += entry.at(++i); continue; }
+                if (c == '"') {
+                    if (i + 1 < entry.size() && entry.at(i + 1) == '=') valueStart = i + 2;
+                    break;
+                }
+                parsed += c;
+            }
+        }
+        if (valueStart < 0) return false;
+        if (name) *name = parsed;
+        if (data) *data = entry.mid(valueStart);
+        return true;
+    }
 
-        auto installStableBtn = new QPushButton(QIcon::fromTheme("system-software-install"), "Install Wine Stable");
-        auto installStagingBtn = new QPushButton(QIcon::fromTheme("system-software-install"), "Install Wine Staging (Latest)");
-        auto updateBtn = new QPushButton(QIcon::fromTheme("system-software-update"), "Update Wine");
+    static QString unescapeKey(const QString &key) {
+        QString out = key;
+        return out.replace("\\\\", "\\");
+    }
 
-        connect(installStableBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installWineStable);
-        connect(installStagingBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installWineStaging);
-        connect(updateBtn, &QPushButton::clicked, this, &WineOptimizerDialog::updateWine);
+    static QString escapeString(const QString &s) {
+        QString out;
+        for (QChar c : s) {
+            if (c == '\\' || c == '"') out += '\\';
+            if (c == '\n') { out += "\\n"; continue; }
+            out += c;
+        }
+        return out;
+    }
 
-        layout->addWidget(installStableBtn);
-        layout->addWidget(installStagingBtn);
-        layout->addWidget(updateBtn);
-        layout->addStretch();
+    static QString unescapeString(const QString &s) {
+        QString out;
+        for (int i = 0; i < s.size(); ++i) {
+            if (s.at(i) != '\\' || i + 1 >= s.size()) { out += s.at(i); continue; }
+            QChar c = s.at(++i);
+            if (c == 'n') out += '\n';
+            else if (c == 'x') {
+                int len = 0;
+                while (len < 4 && i + 1 + len < s.size()) {
+                    char h = s.at(i + 1 + len).toLatin1();
+                    if (!((h >= '0' && h <= '9') || (h >= 'a' && h <= 'f') || (h >= 'A' && h <= 'F'))) break;
+                    ++len;
+                }
+                out += QChar(char16_t(s.mid(i + 1, len).toUShort(nullptr, 16)));
+                i += len;
+            } else out += c;
+        }
+        return out;
+    }
 
-        return widget;
+    QString filePath;
+    QStringList preamble;
+    QList<Section> sections;
+    QHash<QString, int> sectionIndex;
+};
+
+class WinePrefixScanner {
+public:
+    struct Prefix {
+        QString path;
+        qint64 bytes = 0;
+        QDateTime lastUsed;
+        QString windowsVersion;
+        bool locked = false;
+    };
+
+    static QStringList roots() {
+        const QString home = QDir::homePath();
+        QStringList roots = {
+            home,
+            home + "/.local/share/wineprefixes",
+            home + "/.local/share/bottles/bottles",
+            home + "/.var/app/com.usebottles.bottles/data/bottles/bottles",
+            home + "/.steam/steam/steamapps/compatdata",
+            home + "/Games"
+        };
+        const QString env = qEnvironmentVariable("WINEPREFIX");
+        if (!env.isEmpty()) roots << env;
+        roots << QSettings().value("wine/prefixRoots").toStringList();
+        return roots;
     }
 
-    QWidget* createOptimizeTab() {
-        auto widget = new QWidget;
-        auto layout = new QVBoxLayout(widget);
+    static bool isPrefix(const QString &dir) {
+        return QFileInfo::exists(dir + "/system.reg") && QFileInfo(dir + "/drive_c").isDir();
+    }
 
-        auto infoLabel = new QLabel(
-            "Apply optimizations to improve Wine performance for gaming and applications."
-            );
-        infoLabel->setWordWrap(true);
-        layout->addWidget(infoLabel);
+    static QStringList discover(const QStringList &roots, int maxDepth = 3) {
+        QStringList found;
+        // Remembers the depth each directory was walked with, since a
+        // specific root may be reached at the edge of the home walk first.
+        QHash<QString, int> seen;
+        std::function<void(const QString &, int)> walk = [&](const QString &dir, int depth) {
+            QString canonical = QFileInfo(dir).canonicalFilePath();
+            if (canonical.isEmpty() || seen.value(canonical, -1) >= depth) return;
+            seen.insert(canonical, depth);
+            if (isPrefix(canonical)) {
+                if (!found.contains(canonical)) found << canonical;
+                return;
+            }
+            if (depth <= 0) return;
+            const QStringList subdirs = QDir(canonical).entryList(
+                QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+            for (const QString &name : subdirs) {
+                if (name == ".cache" || name == "Trash" || name == "node_modules" || name == ".git") continue;
+                walk(canonical + "/" + name, depth - 1);
+            }
+        };
+        for (const QString &root : roots)
+            walk(root, maxDepth);
+        return found;
+    }
 
-        auto presetsGroup = new QGroupBox("Performance Presets");
-        auto presetsLayout = new QVBoxLayout(presetsGroup);
+    static Prefix inspect(const QString &path) {
+        Prefix p;
+        p.path = path;
+        p.locked = WineRegistry::isPrefixLocked(path);
+        p.bytes = directorySize(path);
 
-        auto gamingBtn = new QPushButton(QIcon::fromTheme("applications-games"), "Gaming Preset (Max Performance)");
-        auto balancedBtn = new QPushButton(QIcon::fromTheme("preferences-system"), "Balanced Preset");
-        auto compatBtn = new QPushButton(QIcon::fromTheme("system-run"), "Compatibility Preset");
+        for (const char *hive : {"user.reg", "system.reg", "userdef.reg"}) {
+            QDateTime modified = QFileInfo(path + "/" + hive).lastModified();
+            if (modified.isValid() && (!p.lastUsed.isValid() || modified > p.lastUsed))
+                p.lastUsed = modified;
+        }
 
-        connect(gamingBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyGamingPreset);
-        connect(balancedBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyBalancedPreset);
-        connect(compatBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyCompatPreset);
+        WineRegistry reg;
+        if (reg.load(WineRegistry::hivePath(path, WineRegistry::UserHive)))
+            p.windowsVersion = reg.value("Software\\Wine", "Version").toString();
+        if (p.windowsVersion.isEmpty() && reg.load(WineRegistry::hivePath(path, WineRegistry::SystemHive)))
+            p.windowsVersion = reg.value("Software\\Microsoft\\Windows NT\\CurrentVersion", "ProductName").toString();
+        return p;
+    }
 
-        presetsLayout->addWidget(gamingBtn);
-        presetsLayout->addWidget(balancedBtn);
-        presetsLayout->addWidget(compatBtn);
+    static qint64 directorySize(const QString &path) {
+        qint64 total = 0;
+        QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            total += it.fileInfo().size();
+        }
+        return total;
+    }
+};
+
+class WineCleanupEngine {
+public:
+    enum Category { WineCache, WinetricksCache, ShaderCache, PrefixTemp, CategoryCount };
+
+    struct Target {
+        Category category = WineCache;
+        QString path;
+        QStringList nameFilters;
+        qint64 bytes = 0;
+        QStringList files;
+        QStringList dirs;
+    };
+
+    static QString categoryName(Category c) {
+        switch (c) {
+        case WineCache: return "Wine cache";
+        case WinetricksCache: return "Winetricks cache";
+        case ShaderCache: return "Shader caches (DXVK/VKD3D)";
+        case PrefixTemp: return "Prefix temp files";
+        default: return "Other";
+        }
+    }
+
+    static QList<Target> candidates(const QStringList &prefixes) {
+        const QString home = QDir::homePath();
+        QList<Target> targets = {
+            {WineCache, home + "/.cache/wine"},
+            {WinetricksCache, home + "/.cache/winetricks"},
+            {ShaderCache, home + "/.cache/dxvk"},
+            {ShaderCache, home + "/.cache/vkd3d-proton"},
+        };
+        for (const QString &prefix : prefixes) {
+            targets << Target{PrefixTemp, prefix + "/drive_c/windows/temp"};
+            const QStringList users = QDir(prefix + "/drive_c/users").entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+            for (const QString &user : users) {
+                targets << Target{PrefixTemp, prefix + "/drive_c/users/" + user + "/Temp"};
+                targets << Target{PrefixTemp, prefix + "/drive_c/users/" + user + "/AppData/Local/Temp"};
+            }
+            targets << Target{ShaderCache, prefix + "/drive_c", {"*.dxvk-cache", "vkd3d-proton.cache*"}};
+        }
+        return targets;
+    }
+
+    // Collects what a target would free; the target directory itself is kept.
+    static Target measure(Target t) {
+        QDirIterator::IteratorFlags flags = QDirIterator::Subdirectories;
+        QDir::Filters filters = QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks | QDir::NoDotAndDotDot;
+        if (t.nameFilters.isEmpty()) filters |= QDir::Dirs;
+
+        QDirIterator it(t.path, t.nameFilters, filters, flags);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo fi = it.fileInfo();
+            if (fi.isDir()) {
+                t.dirs << fi.filePath();
+            } else {
+                t.files << fi.filePath();
+                t.bytes += fi.size();
+            }
+        }
+        // Deepest first so rmdir only ever sees emptied directories.
+        std::sort(t.dirs.begin(), t.dirs.end(), [](const QString &a, const QString &b) {
+            return a.count('/') > b.count('/');
+        });
+        return t;
+    }
+
+    static qint64 removeFile(const QString &path) {
+        qint64 size = QFileInfo(path).size();
+        return QFile::remove(path) ? size : 0;
+    }
+};
+
+class WineLaunchProfile {
+public:
+    QString name;
+    QString executable;
+    QString prefix;
+    bool esync = true;
+    bool fsync = false;
+    bool quietDebug = true;
+    bool gamemode = false;
+    QString dxvkHud;
+    QString cpuAffinity;
+    int niceLevel = 0;
+
+    QProcessEnvironment environment() const {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("WINEPREFIX", prefix);
+        env.remove("WINEESYNC");
+        env.remove("WINEFSYNC");
+        if (esync) env.insert("WINEESYNC", "1");
+        if (fsync) env.insert("WINEFSYNC", "1");
+        if (quietDebug) env.insert("WINEDEBUG", "-all");
+        if (!dxvkHud.isEmpty()) env.insert("DXVK_HUD", dxvkHud);
+        return env;
+    }
+
+    // gamemoderun -> taskset -> nice -> wine, each wrapper only when asked for.
+    void prepare(QProcess &proc) const {
+        QStringList chain;
+        if (gamemode && !QStandardPaths::findExecutable("gamemoderun").isEmpty())
+            chain << "gamemoderun";
+        if (!cpuAffinity.isEmpty())
+            chain << "taskset" << "-c" << cpuAffinity;
+        if (niceLevel != 0)
+            chain << "nice" << "-n" << QString::number(niceLevel);
+        chain << "wine" << executable;
+
+        proc.setProgram(chain.takeFirst());
+        proc.setArguments(chain);
+        proc.setProcessEnvironment(environment());
+        proc.setWorkingDirectory(QFileInfo(executable).absolutePath());
+    }
+
+    bool launch() const {
+        QProcess proc;
+        prepare(proc);
+        return proc.startDetached();
+    }
+
+    static QList<WineLaunchProfile> loadAll() {
+        QList<WineLaunchProfile> profiles;
+        QSettings settings;
+        int count = settings.beginReadArray("wine/launchProfiles");
+        for (int i = 0; i < count; ++i) {
+            settings.setArrayIndex(i);
+            WineLaunchProfile p;
+            p.name = settings.value("name").toString();
+            p.executable = settings.value("executable").toString();
+            p.prefix = settings.value("prefix").toString();
+            p.esync = settings.value("esync", true).toBool();
+            p.fsync = settings.value("fsync", false).toBool();
+            p.quietDebug = settings.value("quietDebug", true).toBool();
+            p.gamemode = settings.value("gamemode", false).toBool();
+            p.dxvkHud = settings.value("dxvkHud").toString();
+            p.cpuAffinity = settings.value("cpuAffinity").toString();
+            p.niceLevel = settings.value("niceLevel", 0).toInt();
+            profiles << p;
+        }
+        settings.endArray();
+        return profiles;
+    }
+
+    static void saveAll(const QList<WineLaunchProfile> &profiles) {
+        QSettings settings;
+        settings.remove("wine/launchProfiles");
+        settings.beginWriteArray("wine/launchProfiles", profiles.size());
+        for (int i = 0; i < profiles.size(); ++i) {
+            const WineLaunchProfile &p = profiles.at(i);
+            settings.setArrayIndex(i);
+            settings.setValue("name", p.name);
+            settings.setValue("executable", p.executable);
+            settings.setValue("prefix", p.prefix);
+            settings.setValue("esync", p.esync);
+            settings.setValue("fsync", p.fsync);
+            settings.setValue("quietDebug", p.quietDebug);
+            settings.setValue("gamemode", p.gamemode);
+            settings.setValue("dxvkHud", p.dxvkHud);
+            settings.setValue("cpuAffinity", p.cpuAffinity);
+            settings.setValue("niceLevel", p.niceLevel);
+        }
+        settings.endArray();
+    }
+};
+
+struct WinePreset {
+    enum Id { Gaming, Balanced, Compatibility };
+
+    QString name;
+    QList<WineRegistry::Edit> edits;
+    bool esync = false;
+    bool fsync = false;
+
+    static QList<WinePreset> all() {
+        const QString d3d = "Software\\Wine\\Direct3D";
+        return {
+            {"Gaming", {{WineRegistry::UserHive, d3d, "csmt", 1u},
+                        {WineRegistry::UserHive, d3d, "MaxVersionGL", 0x00040006u}}, true, true},
+            {"Balanced", {}, true, false},
+            {"Compatibility", {{WineRegistry::UserHive, d3d, "StrictDrawOrdering", QString("enabled")}}, false, false},
+        };
+    }
+
+    static WinePreset get(Id id) { return all().at(id); }
+};
+
+class WineBenchmark : public QObject {
+    Q_OBJECT
+public:
+    struct Result {
+        QString preset;
+        QString metric;
+        int samples = 0;
+        double median = 0;
+        double p99 = 0;
+    };
+
+    WineBenchmark(const WineLaunchProfile &profile, int warmupSec, int durationSec, QObject *parent = nullptr)
+        : QObject(parent), profile(profile), warmupMs(warmupSec * 1000), durationMs(durationSec * 1000)
+    {
+        useMangoHud = !QStandardPaths::findExecutable("mangohud").isEmpty();
+        sampleTimer.setInterval(sampleIntervalMs);
+        connect(&sampleTimer, &QTimer::timeout, this, &WineBenchmark::sample);
+    }
+
+    void start() {
+        if (WineRegistry::isPrefixLocked(profile.prefix)) {
+            emit message("Close all programs running in this prefix before benchmarking.");
+            emit finished({});
+            return;
+        }
+
+        // Remember what the presets touch so every run starts from the same state.
+        WineRegistry user, system;
+        user.load(WineRegistry::hivePath(profile.prefix, WineRegistry::UserHive));
+        system.load(WineRegistry::hivePath(profile.prefix, WineRegistry::SystemHive));
+        for (const WinePreset &preset : WinePreset::all()) {
+            for (const WineRegistry::Edit &e : preset.edits) {
+                const WineRegistry &reg = e.hive == WineRegistry::UserHive ? user : system;
+                baseline << WineRegistry::Edit{e.hive, e.key, e.name, reg.value(e.key, e.name)};
+            }
+        }
+
+        emit message(useMangoHud ? "Collecting frame times through MangoHud."
+                                 : "MangoHud not found, sampling CPU/GPU time from /proc instead of frame times.");
+        nextRun();
+    }
+
+signals:
+    void message(const QString &text);
+    void finished(const QList<WineBenchmark::Result> &results);
+
+private slots:
+    void nextRun() {
+        const QList<WinePreset> presets = WinePreset::all();
+        if (runIndex >= presets.size()) {
+            WineRegistry::apply(profile.prefix, baseline);
+            emit message("Registry settings restored.");
+            emit finished(results);
+            return;
+        }
+
+        const WinePreset preset = presets.at(runIndex);
+        WineRegistry::apply(profile.prefix, baseline + preset.edits);
+
+        WineLaunchProfile run = profile;
+        run.esync = preset.esync;
+        run.fsync = preset.fsync;
+        run.prepare(process);
+
+        if (useMangoHud) {
+            logDir.reset(new QTemporaryDir);
+            QProcessEnvironment env = process.processEnvironment();
+            env.insert("MANGOHUD_CONFIG", QString("no_display,output_folder=%1,autostart_log=%2,log_duration=%3,log_interval=0")
+                                              .arg(logDir->path()).arg(warmupMs / 1000).arg(durationMs / 1000));
+            process.setProcessEnvironment(env);
+            process.setArguments(QStringList{process.program()} + process.arguments());
+            process.setProgram("mangohud");
+        }
+
+        cpuSamples.clear();
+        gpuSamples.clear();
+        lastUsage.clear();
+        emit message(QString("Running %1 preset for %2 s (+%3 s warm-up)...")
+                         .arg(preset.name).arg(durationMs / 1000).arg(warmupMs / 1000));
+        process.start();
+        if (!process.waitForStarted(5000)) {
+            emit message(QString("Failed to start %1").arg(profile.executable));
+            ++runIndex;
+            QTimer::singleShot(0, this, &WineBenchmark::nextRun);
+            return;
+        }
+
+        if (!useMangoHud) {
+            QTimer::singleShot(warmupMs, this, [this]() {
+                lastUsage = usage(process.processId());
+                sampleTimer.start();
+            });
+        }
+        QTimer::singleShot(warmupMs + durationMs, this, &WineBenchmark::stopRun);
+    }
+
+    void sample() {
+        QHash<qint64, Usage> now = usage(process.processId());
+        double cpuMs = 0, gpuMs = 0;
+        for (auto it = now.constBegin(); it != now.constEnd(); ++it) {
+            auto prev = lastUsage.constFind(it.key());
+            if (prev == lastUsage.constEnd()) continue;
+            cpuMs += (it->cpuTicks - prev->cpuTicks) * 1000.0 / ::sysconf(_SC_CLK_TCK);
+            gpuMs += (it->gpuNs - prev->gpuNs) / 1e6;
+        }
+        lastUsage = now;
+        cpuSamples << cpuMs;
+        gpuSamples << gpuMs;
+    }
+
+    void stopRun() {
+        sampleTimer.stop();
+        auto killer = new QProcess(this);
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        env.insert("WINEPREFIX", profile.prefix);
+        killer->setProcessEnvironment(env);
+        connect(killer, &QProcess::finished, this, [this, killer]() {
+            killer->deleteLater();
+            collectRun();
+        });
+        connect(killer, &QProcess::errorOccurred, this, [this, killer](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart) return;
+            killer->deleteLater();
+            process.kill();
+            collectRun();
+        });
+        killer->start("wineserver", {"-k"});
+    }
+
+private:
+    struct Usage {
+        qint64 cpuTicks = 0;
+        qint64 gpuNs = 0;
+    };
+
+    // Waits for the game to exit without blocking the GUI; the timer kills
+    // it if wineserver -k did not bring it down.
+    void collectRun() {
+        if (process.state() == QProcess::NotRunning) {
+            finishRun();
+            return;
+        }
+        auto killTimer = new QTimer(this);
+        killTimer->setSingleShot(true);
+        connect(killTimer, &QTimer::timeout, &process, &QProcess::kill);
+        connect(&process, &QProcess::finished, this, [this, killTimer]() {
+            killTimer->deleteLater();
+            finishRun();
+        }, Qt::SingleShotConnection);
+        killTimer->start(5000);
+    }
+
+    void finishRun() {
+        const QString presetName = WinePreset::all().at(runIndex).name;
+        if (useMangoHud) {
+            addResult(presetName, "frame time (ms)", readMangoHudLog(logDir->path()));
+        } else {
+            addResult(presetName, QString("CPU ms per %1 ms").arg(sampleIntervalMs), cpuSamples);
+            addResult(presetName, QString("GPU ms per %1 ms").arg(sampleIntervalMs), gpuSamples);
+        }
+        ++runIndex;
+        nextRun();
+    }
+
+    void addResult(const QString &preset, const QString &metric, QList<double> values) {
+        Result r;
+        r.preset = preset;
+        r.metric = metric;
+        r.samples = values.size();
+        if (!values.isEmpty()) {
+            std::sort(values.begin(), values.end());
+            r.median = values.at(values.size() / 2);
+            r.p99 = values.at(qMin(values.size() - 1, qsizetype(std::ceil(values.size() * 0.99)) - 1));
+        }
+        results << r;
+        emit message(QString("  %1: %2 median %3, p99 %4 (%5 samples)")
+                         .arg(preset, metric).arg(r.median, 0, 'f', 2).arg(r.p99, 0, 'f', 2).arg(r.samples));
+    }
+
+    // CPU ticks and DRM engine time of a process and all of its descendants.
+    static QHash<qint64, Usage> usage(qint64 rootPid) {
+        QHash<qint64, qint64> parents;
+        QHash<qint64, qint64> ticks;
+        const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &pidName : pids) {
+            bool ok;
+            qint64 pid = pidName.toLongLong(&ok);
+            if (!ok) continue;
+            QFile f("/proc/" + pidName + "/stat");
+            if (!f.open(QIODevice::ReadOnly)) continue;
+            QByteArray stat = f.readAll();
+            const QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+            if (fields.size() < 13) continue;
+            parents.insert(pid, fields.at(1).toLongLong());
+            ticks.insert(pid, fields.at(11).toLongLong() + fields.at(12).toLongLong());
+        }
+
+        QHash<qint64, Usage> tree;
+        QList<qint64> pending = {rootPid};
+        while (!pending.isEmpty()) {
+            qint64 pid = pending.takeLast();
+            if (tree.contains(pid) || !ticks.contains(pid)) continue;
+            Usage u;
+            u.cpuTicks = ticks.value(pid);
+            u.gpuNs = drmEngineTime(pid);
+            tree.insert(pid, u);
+            for (auto it = parents.constBegin(); it != parents.constEnd(); ++it)
+                if (it.value() == pid) pending << it.key();
+        }
+        return tree;
+    }
+
+    static qint64 drmEngineTime(qint64 pid) {
+        qint64 total = 0;
+        QSet<QByteArray> clients;
+        const QString dir = QString("/proc/%1/fdinfo").arg(pid);
+        const QStringList fds = QDir(dir).entryList(QDir::Files);
+        for (const QString &fd : fds) {
+            QFile f(dir + "/" + fd);
+            if (!f.open(QIODevice::ReadOnly)) continue;
+            const QByteArray info = f.readAll();
+            if (!info.contains("drm-engine-")) continue;
+            QByteArray client;
+            qint64 ns = 0;
+            for (const QByteArray &line : info.split('\n')) {
+                if (line.startsWith("drm-client-id:")) client = line.mid(14).trimmed();
+                else if (line.startsWith("drm-engine-")) ns += line.mid(line.indexOf(':') + 1).trimmed().split(' ').first().toLongLong();
+            }
+            if (!client.isEmpty() && clients.contains(client)) continue;
+            clients.insert(client);
+            total += ns;
+        }
+        return total;
+    }
+
+    static QList<double> readMangoHudLog(const QString &dir) {
+        QList<double> frameTimes;
+        const QFileInfoList logs = QDir(dir).entryInfoList({"*.csv"}, QDir::Files, QDir::Time);
+        if (logs.isEmpty()) return frameTimes;
+
+        QFile f(logs.first().filePath());
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return frameTimes;
+        int column = -1;
+        while (!f.atEnd()) {
+            const QList<QByteArray> fields = f.readLine().trimmed().split(',');
+            if (column < 0) {
+                if (fields.value(0) == "fps") column = fields.indexOf("frametime");
+                continue;
+            }
+            bool ok;
+            double ms = fields.value(column).toDouble(&ok);
+            if (ok) frameTimes << ms;
+        }
+        return frameTimes;
+    }
+
+    WineLaunchProfile profile;
+    const int warmupMs;
+    const int durationMs;
+    const int sampleIntervalMs = 100;
+    bool useMangoHud = false;
+    int runIndex = 0;
+    QProcess process;
+    QTimer sampleTimer;
+    QScopedPointer<QTemporaryDir> logDir;
+    QList<WineRegistry::Edit> baseline;
+    QHash<qint64, Usage> lastUsage;
+    QList<double> cpuSamples;
+    QList<double> gpuSamples;
+    QList<Result> results;
+};
+
+class WineOptimizerDialog : public QDialog {
+    Q_OBJECT
+public:
+    WineOptimizerDialog(QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowTitle("Wine Configuration & Optimizer");
+        setWindowIcon(QIcon::fromTheme("winecfg"));
+        setMinimumSize(700, 650);
+        resize(700, 650);
+
+        auto mainLayout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Wine Optimizer & Configurator");
+
+        titleLabel->setProperty("class", "titleText");
+        mainLayout->addWidget(titleLabel);
+
+
+        statusLabel = new QLabel("Checking Wine installation...");
+        mainLayout->addWidget(statusLabel);
+
+        auto tabs = new QTabWidget;
+        tabs->addTab(makeScrollable(createInstallTab()), QIcon::fromTheme("system-software-install"), "Install/Update");
+        tabs->addTab(makeScrollable(createOptimizeTab()), QIcon::fromTheme("preferences-system-performance"), "Optimize");
+        tabs->addTab(makeScrollable(createProfilesTab()), QIcon::fromTheme("system-run"), "Launch Profiles");
+        tabs->addTab(makeScrollable(createBenchmarkTab()), QIcon::fromTheme("utilities-system-monitor"), "Benchmark");
+        tabs->addTab(makeScrollable(createConfigTab()), QIcon::fromTheme("preferences-system"), "Configure");
+        tabs->addTab(makeScrollable(createCleanupTab()), QIcon::fromTheme("edit-clear-all"), "Cleanup");
+
+        logArea = new QTextEdit;
+        logArea->setReadOnly(true);
+        logArea->setMaximumHeight(150);
+
+        auto closeBtn = new QPushButton(QIcon::fromTheme("window-close"), "Close");
+        connect(closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+
+        mainLayout->addWidget(tabs, 1);
+        mainLayout->addWidget(logArea);
+        mainLayout->addWidget(closeBtn);
+
+        launchProfiles = WineLaunchProfile::loadAll();
+        reloadProfileList(0);
+        checkWineInstallation();
+        refreshRegistryView();
+        scanPrefixes();
+    }
+
+private:
+    QWidget* makeScrollable(QWidget *content) {
+        QScrollArea *scroll = new QScrollArea;
+        scroll->setWidgetResizable(true);
+        scroll->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+        scroll->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+        scroll->setWidget(content);
+        scroll->setFrameShape(QFrame::NoFrame);
+        return scroll;
+    }
+
+    QWidget* createInstallTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel(
+            "Wine allows you to run Windows applications on Linux.\n"
+            "Install or update Wine to the latest version."
+            );
+        infoLabel->setWordWrap(true);
+        layout->addWidget(infoLabel);
+
+        wineVersionLabel = new QLabel("Wine Version: Checking...");
+        layout->addWidget(wineVersionLabel);
+
+        auto installStableBtn = new QPushButton(QIcon::fromTheme("system-software-install"), "Install Wine Stable");
+        auto installStagingBtn = new QPushButton(QIcon::fromTheme("system-software-install"), "Install Wine Staging (Latest)");
+        auto updateBtn = new QPushButton(QIcon::fromTheme("system-software-update"), "Update Wine");
+
+        connect(installStableBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installWineStable);
+        connect(installStagingBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installWineStaging);
+        connect(updateBtn, &QPushButton::clicked, this, &WineOptimizerDialog::updateWine);
+
+        layout->addWidget(installStableBtn);
+        layout->addWidget(installStagingBtn);
+        layout->addWidget(updateBtn);
+        layout->addStretch();
+
+        return widget;
+    }
+
+    QWidget* createOptimizeTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel(
+            "Apply optimizations to improve Wine performance for gaming and applications."
+            );
+        infoLabel->setWordWrap(true);
+        layout->addWidget(infoLabel);
+
+        auto currentGroup = new QGroupBox("Current Prefix Settings");
+        auto currentLayout = new QVBoxLayout(currentGroup);
+        registryViewLabel = new QLabel;
+        registryViewLabel->setWordWrap(true);
+        currentLayout->addWidget(registryViewLabel);
+        auto reloadBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Reload");
+        connect(reloadBtn, &QPushButton::clicked, this, &WineOptimizerDialog::refreshRegistryView);
+        currentLayout->addWidget(reloadBtn);
+
+        auto presetsGroup = new QGroupBox("Performance Presets");
+        auto presetsLayout = new QVBoxLayout(presetsGroup);
+
+        auto gamingBtn = new QPushButton(QIcon::fromTheme("applications-games"), "Gaming Preset (Max Performance)");
+        auto balancedBtn = new QPushButton(QIcon::fromTheme("preferences-system"), "Balanced Preset");
+        auto compatBtn = new QPushButton(QIcon::fromTheme("system-run"), "Compatibility Preset");
+
+        connect(gamingBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyGamingPreset);
+        connect(balancedBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyBalancedPreset);
+        connect(compatBtn, &QPushButton::clicked, this, &WineOptimizerDialog::applyCompatPreset);
+
+        presetsLayout->addWidget(gamingBtn);
+        presetsLayout->addWidget(balancedBtn);
+        presetsLayout->addWidget(compatBtn);
+
+        auto optimGroup = new QGroupBox("Individual Optimizations");
+        auto optimLayout = new QVBoxLayout(optimGroup);
+
+        auto esyncBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Enable ESYNC (Event Synchronization)");
+        auto fsyncBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Enable FSYNC (Fast Synchronization)");
+        auto dxvkBtn = new QPushButton(QIcon::fromTheme("applications-graphics"), "Install DXVK (DirectX to Vulkan)");
+        auto vkd3dBtn = new QPushButton(QIcon::fromTheme("applications-graphics"), "Install VKD3D (DirectX 12 to Vulkan)");
+        auto largeAddrBtn = new QPushButton(QIcon::fromTheme("edit-find"), "Enable Large Address Aware");
+
+        connect(esyncBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableEsync);
+        connect(fsyncBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableFsync);
+        connect(dxvkBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installDXVK);
+        connect(vkd3dBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installVKD3D);
+        connect(largeAddrBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableLargeAddr);
+
+        optimLayout->addWidget(esyncBtn);
+        optimLayout->addWidget(fsyncBtn);
+        optimLayout->addWidget(dxvkBtn);
+        optimLayout->addWidget(vkd3dBtn);
+        optimLayout->addWidget(largeAddrBtn);
+
+        layout->addWidget(currentGroup);
+        layout->addWidget(presetsGroup);
+        layout->addWidget(optimGroup);
+        layout->addStretch();
+
+        return widget;
+    }
+
+    QWidget* createProfilesTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel(
+            "Each Windows application gets its own environment (ESYNC/FSYNC, DXVK HUD, debug output, "
+            "CPU affinity, priority, gamemode) and is launched from here with exactly those settings."
+            );
+        infoLabel->setWordWrap(true);
+        layout->addWidget(infoLabel);
+
+        profileList = new QListWidget;
+        profileList->setMaximumHeight(120);
+        layout->addWidget(profileList);
+        connect(profileList, &QListWidget::currentRowChanged, this, &WineOptimizerDialog::showProfile);
+
+        auto formGroup = new QGroupBox("Profile");
+        auto form = new QFormLayout(formGroup);
+        profileNameEdit = new QLineEdit;
+        profileExeEdit = new QLineEdit;
+        auto browseBtn = new QPushButton(QIcon::fromTheme("document-open"), "Browse...");
+        connect(browseBtn, &QPushButton::clicked, this, [this]() {
+            QString exe = QFileDialog::getOpenFileName(this, "Select Windows Executable", currentPrefix() + "/drive_c",
+                                                       "Windows programs (*.exe *.msi *.bat *.lnk)");
+            if (!exe.isEmpty()) profileExeEdit->setText(exe);
+        });
+        auto exeRow = new QHBoxLayout;
+        exeRow->addWidget(profileExeEdit, 1);
+        exeRow->addWidget(browseBtn);
+        profilePrefixLabel = new QLabel;
+        profileEsyncCheck = new QCheckBox("ESYNC (WINEESYNC=1)");
+        profileFsyncCheck = new QCheckBox("FSYNC (WINEFSYNC=1)");
+        profileQuietCheck = new QCheckBox("Silence Wine debug output (WINEDEBUG=-all)");
+        profileGamemodeCheck = new QCheckBox("Run under gamemode");
+        profileHudEdit = new QLineEdit;
+        profileHudEdit->setPlaceholderText("e.g. fps,frametimes (empty = off)");
+        profileAffinityEdit = new QLineEdit;
+        profileAffinityEdit->setPlaceholderText("e.g. 0-3 (empty = all CPUs)");
+        profileNiceSpin = new QSpinBox;
+        profileNiceSpin->setRange(0, 19);
+
+        form->addRow("Name:", profileNameEdit);
+        form->addRow("Executable:", exeRow);
+        form->addRow("Prefix:", profilePrefixLabel);
+        form->addRow(profileEsyncCheck);
+        form->addRow(profileFsyncCheck);
+        form->addRow(profileQuietCheck);
+        form->addRow(profileGamemodeCheck);
+        form->addRow("DXVK HUD:", profileHudEdit);
+        form->addRow("CPU affinity:", profileAffinityEdit);
+        form->addRow("Nice level:", profileNiceSpin);
+        layout->addWidget(formGroup);
+
+        auto buttons = new QHBoxLayout;
+        auto newBtn = new QPushButton(QIcon::fromTheme("list-add"), "New");
+        auto saveBtn = new QPushButton(QIcon::fromTheme("document-save"), "Save");
+        auto deleteBtn = new QPushButton(QIcon::fromTheme("edit-delete"), "Delete");
+        auto launchBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Launch");
+        connect(newBtn, &QPushButton::clicked, this, [this]() {
+            profileList->clearSelection();
+            profileList->setCurrentRow(-1);
+            showProfile(-1);
+        });
+        connect(saveBtn, &QPushButton::clicked, this, &WineOptimizerDialog::saveProfile);
+        connect(deleteBtn, &QPushButton::clicked, this, &WineOptimizerDialog::deleteProfile);
+        connect(launchBtn, &QPushButton::clicked, this, &WineOptimizerDialog::launchProfile);
+        buttons->addWidget(newBtn);
+        buttons->addWidget(saveBtn);
+        buttons->addWidget(deleteBtn);
+        buttons->addWidget(launchBtn);
+        layout->addLayout(buttons);
+        layout->addStretch();
+
+        return widget;
+    }
+
+    QWidget* createBenchmarkTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel(
+            "Runs a launch profile once per preset (Gaming, Balanced, Compatibility) and reports the median "
+            "and 99th percentile frame time. Frame times come from MangoHud when it is installed; otherwise "
+            "CPU and GPU time of the game's processes are sampled from /proc."
+            );
+        infoLabel->setWordWrap(true);
+        layout->addWidget(infoLabel);
+
+        auto form = new QFormLayout;
+        benchProfileCombo = new QComboBox;
+        benchWarmupSpin = new QSpinBox;
+        benchWarmupSpin->setRange(0, 300);
+        benchWarmupSpin->setValue(15);
+        benchWarmupSpin->setSuffix(" s");
+        benchDurationSpin = new QSpinBox;
+        benchDurationSpin->setRange(5, 600);
+        benchDurationSpin->setValue(60);
+        benchDurationSpin->setSuffix(" s");
+        form->addRow("Launch profile:", benchProfileCombo);
+        form->addRow("Warm-up:", benchWarmupSpin);
+        form->addRow("Measure:", benchDurationSpin);
+        layout->addLayout(form);
+
+        benchRunBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Run Benchmark");
+        connect(benchRunBtn, &QPushButton::clicked, this, &WineOptimizerDialog::runBenchmark);
+        layout->addWidget(benchRunBtn);
+
+        benchResultsLabel = new QLabel("No results yet.");
+        benchResultsLabel->setWordWrap(true);
+        benchResultsLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        layout->addWidget(benchResultsLabel);
+        layout->addStretch();
+
+        return widget;
+    }
+
+    QWidget* createConfigTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel("Configure Wine prefixes and Windows version emulation.");
+        layout->addWidget(infoLabel);
+
+        auto prefixGroup = new QGroupBox("Wine Prefix");
+        auto prefixLayout = new QVBoxLayout(prefixGroup);
+
+        auto prefixLabel = new QLabel("Select or create a Wine prefix:");
+        prefixLayout->addWidget(prefixLabel);
+
+        winePrefixCombo = new QComboBox;
+        winePrefixCombo->addItem("Default (~/.wine)", WineRegistry::defaultPrefix());
+        winePrefixCombo->setEditable(false);
+        prefixLayout->addWidget(winePrefixCombo);
+        connect(winePrefixCombo, &QComboBox::currentIndexChanged, this, &WineOptimizerDialog::refreshRegistryView);
+
+        allPrefixesCheck = new QCheckBox("Apply presets and cleanup to all discovered prefixes");
+        prefixLayout->addWidget(allPrefixesCheck);
+
+        auto rescanBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Rescan Prefixes");
+        connect(rescanBtn, &QPushButton::clicked, this, &WineOptimizerDialog::scanPrefixes);
+        prefixLayout->addWidget(rescanBtn);
+
+        customPrefixEdit = new QLineEdit;
+        customPrefixEdit->setPlaceholderText("Or enter custom prefix path...");
+        prefixLayout->addWidget(customPrefixEdit);
+
+        auto createPrefixBtn = new QPushButton(QIcon::fromTheme("list-add"), "Create New Prefix");
+        connect(createPrefixBtn, &QPushButton::clicked, this, &WineOptimizerDialog::createPrefix);
+        prefixLayout->addWidget(createPrefixBtn);
+
+        auto winverGroup = new QGroupBox("Windows Version");
+        auto winverLayout = new QVBoxLayout(winverGroup);
+
+        auto winverCombo = new QComboBox;
+        winverCombo->addItems({"Windows 10", "Windows 8.1", "Windows 7", "Windows XP"});
+        winverLayout->addWidget(winverCombo);
+
+        auto setWinverBtn = new QPushButton(QIcon::fromTheme("preferences-desktop"), "Set Windows Version");
+        connect(setWinverBtn, &QPushButton::clicked, [this, winverCombo]() {
+            setWindowsVersion(winverCombo->currentText());
+        });
+        winverLayout->addWidget(setWinverBtn);
+
+        auto toolsGroup = new QGroupBox("Tools");
+        auto toolsLayout = new QVBoxLayout(toolsGroup);
+
+        auto winecfgBtn = new QPushButton(QIcon::fromTheme("preferences-system"), "Open Wine Configuration (winecfg)");
+        auto regeditBtn = new QPushButton(QIcon::fromTheme("edit-find-replace"), "Open Wine Registry Editor");
+        auto taskmgrBtn = new QPushButton(QIcon::fromTheme("utilities-system-monitor"), "Open Wine Task Manager");
+
+        connect(winecfgBtn, &QPushButton::clicked, []() { QProcess::startDetached("winecfg"); });
+        connect(regeditBtn, &QPushButton::clicked, []() { QProcess::startDetached("wine", {"regedit"}); });
+        connect(taskmgrBtn, &QPushButton::clicked, []() { QProcess::startDetached("wine", {"taskmgr"}); });
+
+        toolsLayout->addWidget(winecfgBtn);
+        toolsLayout->addWidget(regeditBtn);
+        toolsLayout->addWidget(taskmgrBtn);
+
+        layout->addWidget(prefixGroup);
+        layout->addWidget(winverGroup);
+        layout->addWidget(toolsGroup);
+        layout->addStretch();
+
+        return widget;
+    }
+
+    QWidget* createCleanupTab() {
+        auto widget = new QWidget;
+        auto layout = new QVBoxLayout(widget);
+
+        auto infoLabel = new QLabel(
+            "Clean up Wine prefixes, cache, and temporary files to free disk space."
+            );
+        infoLabel->setWordWrap(true);
+        layout->addWidget(infoLabel);
+
+        cleanupList = new QListWidget;
+        layout->addWidget(cleanupList);
+
+        cleanupProgress = new QProgressBar;
+        cleanupProgress->setTextVisible(true);
+        cleanupProgress->setValue(0);
+        layout->addWidget(cleanupProgress);
+
+        auto scanBtn = new QPushButton(QIcon::fromTheme("edit-find"), "Scan Reclaimable Space");
+        cleanSelectedBtn = new QPushButton(QIcon::fromTheme("edit-clear"), "Clean Selected");
+        auto prefixBtn = new QPushButton(QIcon::fromTheme("user-trash"), "Remove Unused Prefixes");
+        auto fullCleanBtn = new QPushButton(QIcon::fromTheme("edit-clear-all"), "Full Cleanup (All Categories)");
+        cleanSelectedBtn->setEnabled(false);
+
+        connect(scanBtn, &QPushButton::clicked, this, &WineOptimizerDialog::scanCleanup);
+        connect(cleanSelectedBtn, &QPushButton::clicked, this, &WineOptimizerDialog::cleanSelected);
+        connect(prefixBtn, &QPushButton::clicked, this, &WineOptimizerDialog::cleanPrefixes);
+        connect(fullCleanBtn, &QPushButton::clicked, this, &WineOptimizerDialog::fullCleanup);
+
+        layout->addWidget(scanBtn);
+        layout->addWidget(cleanSelectedBtn);
+        layout->addWidget(prefixBtn);
+        layout->addWidget(fullCleanBtn);
+        layout->addStretch();
+
+        return widget;
+    }
+
+private slots:
+    void checkWineInstallation() {
+        QString version = execProcess("wine", {"--version"});
+        if (version.isEmpty()) {
+            statusLabel->setText("Wine not installed");
+            wineVersionLabel->setText("Wine Version: Not Installed");
+            logArea->append("Wine is not installed on this system.");
+        } else {
+            statusLabel->setText(QString("Wine installed: %1").arg(version));
+            wineVersionLabel->setText(QString("Wine Version: %1").arg(version));
+            logArea->append(QString("Wine detected: %1").arg(version));
+        }
+    }
+
+    void scanPrefixes() {
+        logArea->append("\nScanning for Wine prefixes...");
+        using PrefixList = QList<WinePrefixScanner::Prefix>;
+        auto watcher = new QFutureWatcher<PrefixList>(this);
+        connect(watcher, &QFutureWatcher<PrefixList>::finished, this, [this, watcher]() {
+            knownPrefixes = watcher->result();
+            watcher->deleteLater();
+
+            const QString selected = currentPrefix();
+            QSignalBlocker blocker(winePrefixCombo);
+            winePrefixCombo->clear();
+            if (!WinePrefixScanner::isPrefix(WineRegistry::defaultPrefix()))
+                winePrefixCombo->addItem("Default (~/.wine)", WineRegistry::defaultPrefix());
+            for (const auto &p : std::as_const(knownPrefixes)) {
+                QString label = QString("%1 (%2, %3, last used %4)")
+                                    .arg(QString(p.path).replace(QDir::homePath(), "~"),
+                                         formatBytes(p.bytes),
+                                         p.windowsVersion.isEmpty() ? QString("default") : p.windowsVersion,
+                                         p.lastUsed.isValid() ? p.lastUsed.toString("dd MMM yyyy") : QString("never"));
+                winePrefixCombo->addItem(label, p.path);
+            }
+            // A prefix picked outside the scanned roots stays selectable; only
+            // one that no longer exists falls back to the first entry.
+            int index = winePrefixCombo->findData(selected);
+            if (index < 0 && QFileInfo(selected).isDir()) {
+                winePrefixCombo->addItem(QString(selected).replace(QDir::homePath(), "~"), selected);
+                index = winePrefixCombo->count() - 1;
+            } else if (index < 0 && !selected.isEmpty()) {
+                logArea->append(QString("Selected prefix %1 no longer exists.").arg(selected));
+            }
+            winePrefixCombo->setCurrentIndex(index >= 0 ? index : 0);
+            blocker.unblock();
+
+            logArea->append(QString("Found %1 Wine prefix(es).").arg(knownPrefixes.size()));
+            refreshRegistryView();
+        });
+        watcher->setFuture(QtConcurrent::run([]() {
+            const QStringList paths = WinePrefixScanner::discover(WinePrefixScanner::roots());
+            return QtConcurrent::blockingMapped<PrefixList>(paths, WinePrefixScanner::inspect);
+        }));
+    }
+
+    void refreshRegistryView() {
+        const QString prefix = currentPrefix();
+        WineRegistry user, system;
+        if (!user.load(WineRegistry::hivePath(prefix, WineRegistry::UserHive))) {
+            registryViewLabel->setText(QString("%1 is not an initialised Wine prefix.").arg(prefix));
+            return;
+        }
+        system.load(WineRegistry::hivePath(prefix, WineRegistry::SystemHive));
+
+        auto show = [](const QVariant &v, const QString &fallback) {
+            if (!v.isValid()) return fallback;
+            if (v.typeId() == QMetaType::QString) return v.toString();
+            return QString("%1 (0x%2)").arg(v.toUInt()).arg(v.toUInt(), 0, 16);
+        };
+        QString winver = user.value("Software\\Wine", "Version").toString();
+        if (winver.isEmpty())
+            winver = system.value("Software\\Microsoft\\Windows NT\\CurrentVersion", "ProductName").toString();
+
+        QStringList lines;
+        lines << QString("Prefix: %1%2").arg(prefix, WineRegistry::isPrefixLocked(prefix) ? " (wineserver running)" : "");
+        lines << QString("Windows version: %1").arg(winver.isEmpty() ? "default" : winver);
+        lines << QString("csmt: %1").arg(show(user.value("Software\\Wine\\Direct3D", "csmt"), "default"));
+        lines << QString("MaxVersionGL: %1").arg(show(user.value("Software\\Wine\\Direct3D", "MaxVersionGL"), "default"));
+        lines << QString("StrictDrawOrdering: %1").arg(show(user.value("Software\\Wine\\Direct3D", "StrictDrawOrdering"), "default"));
+        lines << QString("LargeAddressAware: %1").arg(show(system.value(
+            "System\\CurrentControlSet\\Control\\Session Manager\\Memory Management", "LargeAddressAware"), "not set"));
+        registryViewLabel->setText(lines.join('\n'));
+    }
+
+    void installWineStable() {
+        logArea->append("\nInstalling Wine Stable...");
+        QString cmd = "dpkg --add-architecture i386 && apt update && "
+                      "apt install -y wine wine32 wine64 libwine libwine:i386 fonts-wine";
+        runInTerminal(cmd, this, "Installing Wine Stable");
+        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    }
+
+    void installWineStaging() {
+        logArea->append("\nInstalling Wine Staging...");
+        QString cmd = "dpkg --add-architecture i386 && "
+                      "wget -nc https://dl.winehq.org/wine-builds/winehq.key && "
+                      "apt-key add winehq.key && "
+                      "add-apt-repository 'deb https://dl.winehq.org/wine-builds/debian/ bookworm main' && "
+                      "apt update && apt install -y --install-recommends winehq-staging";
+        runInTerminal(cmd, this, "Installing Wine Staging");
+        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    }
+
+    void updateWine() {
+        logArea->append("\nUpdating Wine...");
+        runInTerminal("apt update && apt upgrade -y wine* winehq*", this, "Updating Wine");
+        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    }
+
+    void applyGamingPreset() {
+        logArea->append("\nApplying Gaming Preset...");
+        logArea->append("  • Enabling ESYNC");
+        logArea->append("  • Enabling FSYNC");
+        logArea->append("  • Installing DXVK");
+        logArea->append("  • Optimizing registry settings");
+
+        applyPreset(WinePreset::get(WinePreset::Gaming));
+        installDXVK();
+    }
+
+    void applyBalancedPreset() {
+        logArea->append("\nApplying Balanced Preset...");
+        applyPreset(WinePreset::get(WinePreset::Balanced));
+    }
+
+    void applyCompatPreset() {
+        logArea->append("\nApplying Compatibility Preset...");
+        applyPreset(WinePreset::get(WinePreset::Compatibility));
+    }
+
+    void runBenchmark() {
+        int row = benchProfileCombo->currentIndex();
+        if (row < 0 || row >= launchProfiles.size()) {
+            logArea->append("\nCreate a launch profile for the game first.");
+            return;
+        }
+        benchRunBtn->setEnabled(false);
+        benchResultsLabel->setText("Running...");
+        logArea->append(QString("\nBenchmarking %1...").arg(launchProfiles.at(row).name));
+
+        auto bench = new WineBenchmark(launchProfiles.at(row), benchWarmupSpin->value(), benchDurationSpin->value(), this);
+        connect(bench, &WineBenchmark::message, logArea, &QTextEdit::append);
+        connect(bench, &WineBenchmark::finished, this, [this, bench](const QList<WineBenchmark::Result> &results) {
+            QStringList lines;
+            for (const auto &r : results) {
+                lines << QString("%1 - %2: median %3, p99 %4 (%5 samples)")
+                             .arg(r.preset, r.metric).arg(r.median, 0, 'f', 2).arg(r.p99, 0, 'f', 2).arg(r.samples);
+            }
+            benchResultsLabel->setText(lines.isEmpty() ? QString("Benchmark did not produce any samples.") : lines.join('\n'));
+            benchRunBtn->setEnabled(true);
+            bench->deleteLater();
+            refreshRegistryView();
+        });
+        bench->start();
+    }
+
+    void enableEsync() {
+        logArea->append("\nEnabling ESYNC...");
+        updateProfiles("ESYNC", [](WineLaunchProfile &p) { p.esync = true; });
+    }
+
+    void enableFsync() {
+        logArea->append("\nEnabling FSYNC...");
+        updateProfiles("FSYNC", [](WineLaunchProfile &p) { p.fsync = true; });
+    }
+
+    void showProfile(int row) {
+        const bool existing = row >= 0 && row < launchProfiles.size();
+        const WineLaunchProfile p = existing ? launchProfiles.at(row) : WineLaunchProfile();
+        profileNameEdit->setText(p.name);
+        profileExeEdit->setText(p.executable);
+        profilePrefixLabel->setText(existing ? p.prefix : QString("%1 (selected prefix)").arg(currentPrefix()));
+        profileEsyncCheck->setChecked(p.esync);
+        profileFsyncCheck->setChecked(p.fsync);
+        profileQuietCheck->setChecked(p.quietDebug);
+        profileGamemodeCheck->setChecked(p.gamemode);
+        profileHudEdit->setText(p.dxvkHud);
+        profileAffinityEdit->setText(p.cpuAffinity);
+        profileNiceSpin->setValue(p.niceLevel);
+    }
+
+    void saveProfile() {
+        WineLaunchProfile p;
+        int row = profileList->currentRow();
+        if (row >= 0 && row < launchProfiles.size()) p = launchProfiles.at(row);
+        else p.prefix = currentPrefix();
+
+        p.name = profileNameEdit->text().trimmed();
+        p.executable = profileExeEdit->text().trimmed();
+        if (p.name.isEmpty()) p.name = QFileInfo(p.executable).completeBaseName();
+        if (p.name.isEmpty() || p.executable.isEmpty()) {
+            logArea->append("\nA launch profile needs an executable.");
+            return;
+        }
+        p.esync = profileEsyncCheck->isChecked();
+        p.fsync = profileFsyncCheck->isChecked();
+        p.quietDebug = profileQuietCheck->isChecked();
+        p.gamemode = profileGamemodeCheck->isChecked();
+        p.dxvkHud = profileHudEdit->text().trimmed();
+        p.cpuAffinity = profileAffinityEdit->text().trimmed();
+        p.niceLevel = profileNiceSpin->value();
+
+        if (row >= 0 && row < launchProfiles.size()) launchProfiles[row] = p;
+        else { launchProfiles << p; row = launchProfiles.size() - 1; }
+        WineLaunchProfile::saveAll(launchProfiles);
+        reloadProfileList(row);
+        logArea->append(QString("\nSaved launch profile: %1").arg(p.name));
+    }
+
+    void deleteProfile() {
+        int row = profileList->currentRow();
+        if (row < 0 || row >= launchProfiles.size()) return;
+        logArea->append(QString("\nDeleted launch profile: %1").arg(launchProfiles.takeAt(row).name));
+        WineLaunchProfile::saveAll(launchProfiles);
+        reloadProfileList(qMin(row, int(launchProfiles.size()) - 1));
+    }
+
+    void launchProfile() {
+        int row = profileList->currentRow();
+        if (row < 0 || row >= launchProfiles.size()) {
+            logArea->append("\nSelect a launch profile first.");
+            return;
+        }
+        const WineLaunchProfile &p = launchProfiles.at(row);
+        if (p.launch())
+            logArea->append(QString("\nLaunched %1 in %2").arg(p.name, p.prefix));
+        else
+            logArea->append(QString("\nFailed to launch %1. Is Wine installed?").arg(p.name));
+    }
+
+    void installDXVK() {
+        logArea->append("\nInstalling DXVK...");
+        runInTerminal("apt install -y dxvk", this, "Installing DXVK");
+    }
+
+    void installVKD3D() {
+        logArea->append("\nInstalling VKD3D...");
+        runInTerminal("apt install -y vkd3d-compiler libvkd3d1 libvkd3d-dev", this, "Installing VKD3D");
+    }
+
+    void enableLargeAddr() {
+        logArea->append("\nEnabling Large Address Aware...");
+        applyRegistryEdits({
+            {WineRegistry::SystemHive, "System\\CurrentControlSet\\Control\\Session Manager\\Memory Management",
+             "LargeAddressAware", 1u},
+        }, "Large Address Aware enabled!");
+    }
+
+    void createPrefix() {
+        QString path = customPrefixEdit->text().trimmed();
+        if (path.isEmpty()) {
+            path = QFileDialog::getExistingDirectory(this, "Select Prefix Location", QDir::homePath());
+        }
+        if (!path.isEmpty()) {
+            logArea->append(QString("\nCreating Wine prefix at: %1").arg(path));
+            QProcess::execute("bash", {"-c", QString("WINEPREFIX='%1' wineboot").arg(path)});
+            logArea->append("Prefix created!");
+            QString created = QFileInfo(path).canonicalFilePath();
+            if (!created.isEmpty()) {
+                QSettings settings;
+                QStringList saved = settings.value("wine/prefixRoots").toStringList();
+                if (!saved.contains(created)) {
+                    saved << created;
+                    settings.setValue("wine/prefixRoots", saved);
+                }
+                winePrefixCombo->addItem(created, created);
+                winePrefixCombo->setCurrentIndex(winePrefixCombo->count() - 1);
+            }
+            scanPrefixes();
+        }
+    }
+
+    void setWindowsVersion(const QString &version) {
+        QString winver;
+        if (version.contains("10")) winver = "win10";
+        else if (version.contains("8")) winver = "win81";
+        else if (version.contains("7")) winver = "win7";
+        else winver = "winxp";
+
+        logArea->append(QString("\nSetting Windows version to: %1").arg(version));
+        applyRegistryEdits({
+            {WineRegistry::UserHive, "Software\\Wine", "Version", winver},
+        }, "Windows version set!");
+    }
+
+    void scanCleanup() {
+        if (cleanupBusy) return;
+        cleanupBusy = true;
+        cleanSelectedBtn->setEnabled(false);
+        cleanupList->clear();
+        logArea->append("\nMeasuring Wine caches and temp files...");
+
+        const QList<WineCleanupEngine::Target> candidates = WineCleanupEngine::candidates(targetPrefixes());
+        cleanupProgress->setRange(0, candidates.size());
+        cleanupProgress->setValue(0);
+
+        auto watcher = new QFutureWatcher<WineCleanupEngine::Target>(this);
+        connect(watcher, &QFutureWatcher<WineCleanupEngine::Target>::progressValueChanged,
+                cleanupProgress, &QProgressBar::setValue);
+        connect(watcher, &QFutureWatcher<WineCleanupEngine::Target>::finished, this, [this, watcher]() {
+            cleanupTargets = watcher->future().results();
+            watcher->deleteLater();
+            cleanupBusy = false;
+
+            qint64 bytes[WineCleanupEngine::CategoryCount] = {};
+            int files[WineCleanupEngine::CategoryCount] = {};
+            for (const auto &t : std::as_const(cleanupTargets)) {
+                bytes[t.category] += t.bytes;
+                files[t.category] += t.files.size();
+            }
+            qint64 total = 0;
+            for (int c = 0; c < WineCleanupEngine::CategoryCount; ++c) {
+                auto item = new QListWidgetItem(QString("%1 - %2 (%3 files)")
+                                                    .arg(WineCleanupEngine::categoryName(WineCleanupEngine::Category(c)),
+                                                         formatBytes(bytes[c]), QString::number(files[c])));
+                item->setData(Qt::UserRole, c);
+                item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+                item->setCheckState(bytes[c] > 0 ? Qt::Checked : Qt::Unchecked);
+                cleanupList->addItem(item);
+                total += bytes[c];
+            }
+            cleanSelectedBtn->setEnabled(total > 0);
+            logArea->append(QString("Reclaimable: %1").arg(formatBytes(total)));
+        });
+        watcher->setFuture(QtConcurrent::mapped(candidates, WineCleanupEngine::measure));
+    }
+
+    void cleanSelected() {
+        if (cleanupBusy) return;
+        QSet<int> categories;
+        for (int i = 0; i < cleanupList->count(); ++i) {
+            if (cleanupList->item(i)->checkState() == Qt::Checked)
+                categories.insert(cleanupList->item(i)->data(Qt::UserRole).toInt());
+        }
+        QStringList files, dirs;
+        for (const auto &t : std::as_const(cleanupTargets)) {
+            if (!categories.contains(t.category)) continue;
+            files << t.files;
+            dirs << t.dirs;
+        }
+        if (files.isEmpty() && dirs.isEmpty()) {
+            logArea->append("\nNothing selected to clean.");
+            return;
+        }
+
+        cleanupBusy = true;
+        cleanSelectedBtn->setEnabled(false);
+        logArea->append(QString("\nRemoving %1 files...").arg(files.size()));
+        cleanupProgress->setRange(0, files.size());
+        cleanupProgress->setValue(0);
+
+        auto watcher = new QFutureWatcher<qint64>(this);
+        connect(watcher, &QFutureWatcher<qint64>::progressValueChanged, cleanupProgress, &QProgressBar::setValue);
+        connect(watcher, &QFutureWatcher<qint64>::finished, this, [this, watcher, dirs]() {
+            logArea->append(QString("Freed %1.").arg(formatBytes(watcher->result())));
+            watcher->deleteLater();
+            for (const QString &dir : dirs) QDir().rmdir(dir);
+            cleanupBusy = false;
+            scanCleanup();
+        });
+        watcher->setFuture(QtConcurrent::mappedReduced<qint64>(
+            files, WineCleanupEngine::removeFile,
+            [](qint64 &total, qint64 freed) { total += freed; },
+            QtConcurrent::UnorderedReduce));
+    }
+
+    void cleanPrefixes() {
+        logArea->append("\nScanning for unused prefixes...");
+        const QDateTime cutoff = QDateTime::currentDateTime().addDays(-unusedPrefixDays);
+        QStringList paths, lines;
+        qint64 total = 0;
+        for (const auto &p : std::as_const(knownPrefixes)) {
+            if (p.locked || !p.lastUsed.isValid() || p.lastUsed >= cutoff) continue;
+            paths << p.path;
+            lines << QString("%1 (%2, last used %3)").arg(p.path, formatBytes(p.bytes), p.lastUsed.toString("dd MMM yyyy"));
+            total += p.bytes;
+        }
+        if (paths.isEmpty()) {
+            logArea->append(QString("No prefixes unused for more than %1 days.").arg(unusedPrefixDays));
+            return;
+        }
+
+        QString msg = QString("These prefixes have not been used for %1 days:\n\n%2\n\nDelete them and free %3?")
+                          .arg(QString::number(unusedPrefixDays), lines.join("\n"), formatBytes(total));
+        if (QMessageBox::question(this, "Remove Unused Prefixes", msg) != QMessageBox::Yes) return;
+
+        auto watcher = new QFutureWatcher<bool>(this);
+        connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+            const QList<bool> results = watcher->future().results();
+            logArea->append(QString("Removed %1 of %2 prefixes.").arg(results.count(true)).arg(results.size()));
+            watcher->deleteLater();
+            scanPrefixes();
+        });
+        watcher->setFuture(QtConcurrent::mapped(paths, [](const QString &path) {
+            return QDir(path).removeRecursively();
+        }));
+    }
+
+    void fullCleanup() {
+        if (QMessageBox::question(this, "Full Cleanup",
+                                  "This will clear all Wine caches, shader caches and temp files.\nContinue?") != QMessageBox::Yes)
+            return;
+        if (cleanupTargets.isEmpty()) {
+            logArea->append("\nRun a scan first to see what can be reclaimed.");
+            scanCleanup();
+            return;
+        }
+        for (int i = 0; i < cleanupList->count(); ++i)
+            cleanupList->item(i)->setCheckState(Qt::Checked);
+        cleanSelected();
+    }
+
+private:
+    QString currentPrefix() const {
+        QString prefix = winePrefixCombo->currentData().toString();
+        return prefix.isEmpty() ? WineRegistry::defaultPrefix() : prefix;
+    }
+
+    QStringList targetPrefixes() const {
+        if (!allPrefixesCheck->isChecked() || knownPrefixes.isEmpty())
+            return {currentPrefix()};
+        QStringList paths;
+        for (const auto &p : knownPrefixes) paths << p.path;
+        return paths;
+    }
+
+    void runOnPrefixes(const QString &doneMessage, const std::function<QStringList(const QString &)> &job) {
+        auto watcher = new QFutureWatcher<QStringList>(this);
+        connect(watcher, &QFutureWatcher<QStringList>::finished, this, [this, watcher, doneMessage]() {
+            for (const QStringList &lines : watcher->future().results()) {
+                for (const QString &line : lines) logArea->append(line);
+            }
+            if (!doneMessage.isEmpty()) logArea->append(doneMessage);
+            watcher->deleteLater();
+            refreshRegistryView();
+        });
+        watcher->setFuture(QtConcurrent::mapped(targetPrefixes(), [job](const QString &prefix) {
+            return QStringList{QString("  [%1]").arg(prefix)} + job(prefix);
+        }));
+    }
+
+    void applyRegistryEdits(const QList<WineRegistry::Edit> &edits, const QString &doneMessage = QString()) {
+        runOnPrefixes(doneMessage, [edits](const QString &prefix) {
+            return WineRegistry::apply(prefix, edits);
+        });
+    }
+
+    void applyPreset(const WinePreset &preset) {
+        if (preset.esync) enableEsync();
+        if (preset.fsync) enableFsync();
+        const QString done = QString("%1 preset applied!").arg(preset.name);
+        if (preset.edits.isEmpty()) logArea->append(done);
+        else applyRegistryEdits(preset.edits, done);
+    }
+
+    void updateProfiles(const QString &what, const std::function<void(WineLaunchProfile &)> &change) {
+        const QStringList prefixes = targetPrefixes();
+        int updated = 0;
+        for (WineLaunchProfile &p : launchProfiles) {
+            if (!prefixes.contains(p.prefix)) continue;
+            change(p);
+            ++updated;
+        }
+        if (updated == 0) {
+            logArea->append("No launch profiles for this prefix yet. Create one in the Launch Profiles tab.");
+            return;
+        }
+        WineLaunchProfile::saveAll(launchProfiles);
+        reloadProfileList(profileList->currentRow());
+        logArea->append(QString("%1 enabled for %2 launch profile(s), applied on their next launch.").arg(what).arg(updated));
+    }
+
+    void reloadProfileList(int selectRow) {
+        QSignalBlocker blocker(profileList);
+        profileList->clear();
+        for (const WineLaunchProfile &p : std::as_const(launchProfiles))
+            profileList->addItem(new QListWidgetItem(QIcon::fromTheme("wine"), QString("%1 - %2").arg(p.name, p.executable)));
+        profileList->setCurrentRow(selectRow);
+        blocker.unblock();
+        showProfile(profileList->currentRow());
+
+        benchProfileCombo->clear();
+        for (const WineLaunchProfile &p : std::as_const(launchProfiles))
+            benchProfileCombo->addItem(p.name);
+    }
+
+    QString execProcess(const QString &program, const QStringList &args, int timeout = 5000) {
+        QProcess proc;
+        proc.start(program, args);
+        if (!proc.waitForFinished(timeout)) {
+            proc.kill();
+        }
+        return QString::fromLocal8Bit(proc.readAllStandardOutput()).trimmed();
+    }
+
+    QLabel *statusLabel;
+    QTextEdit *logArea;
+    QLabel *wineVersionLabel;
+    QLabel *registryViewLabel;
+    QComboBox *winePrefixCombo;
+    QCheckBox *allPrefixesCheck;
+    QLineEdit *customPrefixEdit;
+    QList<WinePrefixScanner::Prefix> knownPrefixes;
+    QListWidget *cleanupList;
+    QProgressBar *cleanupProgress;
+    QPushButton *cleanSelectedBtn;
+    QList<WineCleanupEngine::Target> cleanupTargets;
+    bool cleanupBusy = false;
+    QList<WineLaunchProfile> launchProfiles;
+    QListWidget *profileList;
+    QLineEdit *profileNameEdit;
+    QLineEdit *profileExeEdit;
+    QLabel *profilePrefixLabel;
+    QCheckBox *profileEsyncCheck;
+    QCheckBox *profileFsyncCheck;
+    QCheckBox *profileQuietCheck;
+    QCheckBox *profileGamemodeCheck;
+    QLineEdit *profileHudEdit;
+    QLineEdit *profileAffinityEdit;
+    QSpinBox *profileNiceSpin;
+    QComboBox *benchProfileCombo;
+    QSpinBox *benchWarmupSpin;
+    QSpinBox *benchDurationSpin;
+    QPushButton *benchRunBtn;
+    QLabel *benchResultsLabel;
+    const int unusedPrefixDays = 90;
+};
+class ProcessScanner {
+public:
+    struct Process {
+        int pid = 0;
+        int ppid = 0;
+        QString name;
+        QString user;
+        char state = '?';
+        double cpu = 0;
+        qint64 rssKb = 0;
+        qint64 rssDeltaKb = 0;
+        int threads = 0;
+        int nice = 0;
+    };
+
+    ProcessScanner() {
+        procFd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        pageKb = sysconf(_SC_PAGESIZE) / 1024;
+        ticksPerSecond = sysconf(_SC_CLK_TCK);
+        dents.resize(64 * 1024);
+        clock.start();
+    }
+
+    ~ProcessScanner() {
+        if (procFd >= 0) ::close(procFd);
+    }
+
+    ProcessScanner(const ProcessScanner &) = delete;
+    ProcessScanner &operator=(const ProcessScanner &) = delete;
+
+    // One pass over /proc: getdents64 on a cached dirfd, then openat for
+    // each pid's stat with a buffer reused across the whole scan. status is
+    // only read the first time a pid is seen, for its uid.
+    QList<Process> scan() {
+        QList<Process> list;
+        if (procFd < 0) return list;
+        const double elapsed = clock.restart() / 1000.0;
+        QHash<int, Previous> seen;
+        seen.reserve(previous.size());
+
+        ::lseek(procFd, 0, SEEK_SET);
+        for (;;) {
+            const long n = syscall(SYS_getdents64, procFd, dents.data(), dents.size());
+            if (n <= 0) break;
+            for (long off = 0; off < n;) {
+                auto *d = reinterpret_cast<const LinuxDirent64 *>(dents.data() + off);
+                off += d->d_reclen;
+                if (d->d_name[0] < '1' || d->d_name[0] > '9') continue;
+                Process p;
+                Previous prev;
+                if (readProcess(d->d_name, p, prev, elapsed)) {
+                    seen.insert(p.pid, prev);
+                    list.append(std::move(p));
+                }
+            }
+        }
+        previous.swap(seen);
+        return list;
+    }
+
+private:
+    struct Previous {
+        quint64 startTime = 0;
+        quint64 ticks = 0;
+        qint64 rssKb = 0;
+        uint uid = 0;
+    };
+
+    bool readProcess(const char *pidName, Process &p, Previous &prev, double elapsed) {
+        char path[64];
+        std::snprintf(path, sizeof(path), "%s/stat", pidName);
+        const qsizetype len = readAt(path);
+        if (len <= 0) return false;
+
+        // comm may itself contain spaces and parentheses, so fields are
+        // counted from the last ')'.
+        const char *open = static_cast<const char *>(memchr(buffer.data(), '(', len));
+        const char *close = static_cast<const char *>(memrchr(buffer.data(), ')', len));
+        if (!open || !close || close < open) return false;
+        p.pid = atoi(pidName);
+        p.name = QString::fromUtf8(open + 1, close - open - 1);
+
+        // field[n] is field n of proc(5): 14/15 utime/stime, 22 starttime, 24 rss.
+        std::array<qint64, 25> field{};
+        const char *cursor = close + 2;
+        const char *end = buffer.data() + len;
+        if (cursor < end) p.state = *cursor;
+        for (int i = 4; i < int(field.size()) && cursor < end; ++i) {
+            cursor = static_cast<const char *>(memchr(cursor, ' ', end - cursor));
+            if (!cursor) break;
+            field[i] = std::strtoll(++cursor, nullptr, 10);
+        }
+        p.ppid = int(field[4]);
+        p.nice = int(field[19]);
+        p.threads = int(field[20]);
+        p.rssKb = field[24] * pageKb;
+
+        prev.startTime = field[22];
+        prev.ticks = field[14] + field[15];
+        prev.rssKb = p.rssKb;
+
+        auto it = previous.constFind(p.pid);
+        const bool known = it != previous.constEnd() && it->startTime == prev.startTime;
+        if (known) {
+            prev.uid = it->uid;
+            if (elapsed > 0)
+                p.cpu = 100.0 * (prev.ticks - it->ticks) / (ticksPerSecond * elapsed);
+            p.rssDeltaKb = p.rssKb - it->rssKb;
+        } else {
+            std::snprintf(path, sizeof(path), "%s/status", pidName);
+            const qsizetype statusLen = readAt(path);
+            const QByteArray status = QByteArray::fromRawData(buffer.data(), qMax<qsizetype>(statusLen, 0));
+            const qsizetype uidAt = status.indexOf("\nUid:");
+            if (uidAt >= 0) prev.uid = std::strtoul(status.constData() + uidAt + 5, nullptr, 10);
+        }
+        p.user = userName(prev.uid);
+        return true;
+    }
+
+    qsizetype readAt(const char *path) {
+        const int fd = ::openat(procFd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return -1;
+        const ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        ::close(fd);
+        return n;
+    }
+
+    QString userName(uint uid) {
+        auto it = users.constFind(uid);
+        if (it != users.constEnd()) return *it;
+        const passwd *pw = getpwuid(uid);
+        return *users.insert(uid, pw ? QString::fromLocal8Bit(pw->pw_name) : QString::number(uid));
+    }
+
+    int procFd = -1;
+    long pageKb = 4;
+    long ticksPerSecond = 100;
+    std::vector<char> dents;
+    std::array<char, 4096> buffer{};
+    QElapsedTimer clock;
+    QHash<int, Previous> previous;
+    QHash<uint, QString> users;
+};
+
+class ProcessModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { Pid, Name, User, State, Cpu, Memory, MemoryDelta, Threads, Nice, ColumnCount };
+
+    explicit ProcessModel(QObject *parent = nullptr) : QAbstractTableModel(parent) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : rows.size();
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : ColumnCount;
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override {
+        static const char *titles[] = {"PID", "Name", "User", "State", "CPU %", "Memory", "Δ Memory", "Threads", "Nice"};
+        if (orientation == Qt::Horizontal && role == Qt::DisplayRole) return titles[section];
+        return QVariant();
+    }
+
+    // Qt::UserRole carries the raw value the proxy sorts on.
+    QVariant data(const QModelIndex &index, int role) const override {
+        if (!index.isValid()) return QVariant();
+        const ProcessScanner::Process &p = rows.at(index.row());
+        if (role == Qt::TextAlignmentRole)
+            return index.column() == Name || index.column() == User ? QVariant() : QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        if (role != Qt::DisplayRole && role != Qt::UserRole) return QVariant();
+        const bool raw = role == Qt::UserRole;
+        switch (index.column()) {
+        case Pid: return p.pid;
+        case Name: return p.name;
+        case User: return p.user;
+        case State: return QString(QChar(p.state));
+        case Cpu: return raw ? QVariant(p.cpu) : QVariant(QString::number(p.cpu, 'f', 1));
+        case Memory: return raw ? QVariant(p.rssKb) : QVariant(formatBytes(qulonglong(p.rssKb) * 1024));
+        case MemoryDelta:
+            if (raw) return p.rssDeltaKb;
+            if (p.rssDeltaKb == 0) return QString();
+            return (p.rssDeltaKb > 0 ? "+" : "-") + formatBytes(qulonglong(qAbs(p.rssDeltaKb)) * 1024);
+        case Threads: return p.threads;
+        case Nice: return p.nice;
+        }
+        return QVariant();
+    }
+
+    int pidAt(int row) const { return rows.at(row).pid; }
+
+    // Rows are updated in place so the view keeps its selection and scroll
+    // position: exited pids are removed, new ones appended, the rest changed.
+    void update(QList<ProcessScanner::Process> fresh) {
+        QHash<int, qsizetype> freshIndex;
+        freshIndex.reserve(fresh.size());
+        for (qsizetype i = 0; i < fresh.size(); ++i) freshIndex.insert(fresh[i].pid, i);
+
+        for (qsizetype row = rows.size() - 1; row >= 0; --row) {
+            if (freshIndex.contains(rows[row].pid)) continue;
+            beginRemoveRows(QModelIndex(), row, row);
+            rows.removeAt(row);
+            endRemoveRows();
+        }
+
+        QSet<int> present;
+        for (auto &row : rows) {
+            const qsizetype i = freshIndex.value(row.pid);
+            row = fresh[i];
+            present.insert(row.pid);
+        }
+        if (!rows.isEmpty())
+            emit dataChanged(index(0, 0), index(rows.size() - 1, ColumnCount - 1));
+
+        QList<ProcessScanner::Process> added;
+        for (auto &p : fresh)
+            if (!present.contains(p.pid)) added.append(std::move(p));
+        if (!added.isEmpty()) {
+            beginInsertRows(QModelIndex(), rows.size(), rows.size() + added.size() - 1);
+            rows.append(added);
+            endInsertRows();
+        }
+    }
+
+private:
+    QList<ProcessScanner::Process> rows;
+};
+
+class ProcessPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit ProcessPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Processes");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        auto controls = new QHBoxLayout;
+        filterEdit = new QLineEdit;
+        filterEdit->setPlaceholderText("Filter by name or user");
+        auto endBtn = new QPushButton(QIcon::fromTheme("process-stop"), "End");
+        auto killBtn = new QPushButton(QIcon::fromTheme("edit-delete"), "Kill");
+        auto niceBtn = new QPushButton(QIcon::fromTheme("view-sort-ascending"), "Renice");
+        for (auto btn : {endBtn, killBtn, niceBtn}) btn->setProperty("class", "plainButton");
+        controls->addWidget(filterEdit, 1);
+        controls->addWidget(endBtn);
+        controls->addWidget(killBtn);
+        controls->addWidget(niceBtn);
+        layout->addLayout(controls);
+
+        model = new ProcessModel(this);
+        proxy = new QSortFilterProxyModel(this);
+        proxy->setSourceModel(model);
+        proxy->setSortRole(Qt::UserRole);
+        proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+        proxy->setFilterKeyColumn(-1);
+        proxy->setDynamicSortFilter(true);
+
+        table = new QTableView;
+        table->setModel(proxy);
+        table->setSortingEnabled(true);
+        table->sortByColumn(ProcessModel::Cpu, Qt::DescendingOrder);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->setSelectionMode(QAbstractItemView::SingleSelection);
+        table->verticalHeader()->hide();
+        table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+        table->horizontalHeader()->setSectionResizeMode(ProcessModel::Name, QHeaderView::Stretch);
+        table->setAlternatingRowColors(true);
+        layout->addWidget(table);
+
+        statusLabel = new QLabel;
+        statusLabel->setProperty("class", "smallText");
+        layout->addWidget(statusLabel);
+
+        connect(filterEdit, &QLineEdit::textChanged, proxy, &QSortFilterProxyModel::setFilterFixedString);
+        connect(endBtn, &QPushButton::clicked, this, [this]() { sendSignal(SIGTERM); });
+        connect(killBtn, &QPushButton::clicked, this, [this]() { sendSignal(SIGKILL); });
+        connect(niceBtn, &QPushButton::clicked, this, &ProcessPanel::renice);
+        connect(&timer, &QTimer::timeout, this, &ProcessPanel::refresh);
+        timer.setInterval(1000);
+    }
+
+protected:
+    // Scanning only runs while the tab is on screen.
+    void showEvent(QShowEvent *event) override {
+        refresh();
+        timer.start();
+        QWidget::showEvent(event);
+    }
+
+    void hideEvent(QHideEvent *event) override {
+        timer.stop();
+        QWidget::hideEvent(event);
+    }
+
+private slots:
+    void refresh() {
+        QList<ProcessScanner::Process> list = scanner.scan();
+        double cpu = 0;
+        for (const auto &p : std::as_const(list)) cpu += p.cpu;
+        statusLabel->setText(QString("%1 processes, %2% CPU").arg(list.size()).arg(cpu, 0, 'f', 1));
+        model->update(std::move(list));
+    }
+
+    void renice() {
+        const int pid = selectedPid();
+        if (pid <= 0) return;
+        bool ok = false;
+        const int current = getpriority(PRIO_PROCESS, pid);
+        const int value = QInputDialog::getInt(this, "Renice", QString("New nice value for PID %1:").arg(pid),
+                                               current, -20, 19, 1, &ok);
+        if (!ok) return;
+        if (setpriority(PRIO_PROCESS, pid, value) != 0) {
+            if (errno == EPERM || errno == EACCES)
+                runInTerminal(QString("renice -n %1 -p %2").arg(value).arg(pid), this, "Changing priority...");
+            else
+                QMessageBox::warning(this, "Renice", QString("Could not renice %1: %2").arg(pid).arg(strerror(errno)));
+        }
+        refresh();
+    }
+
+private:
+    int selectedPid() const {
+        const QModelIndexList selected = table->selectionModel()->selectedRows();
+        if (selected.isEmpty()) return -1;
+        return model->pidAt(proxy->mapToSource(selected.first()).row());
+    }
+
+    void sendSignal(int sig) {
+        const int pid = selectedPid();
+        if (pid <= 0) return;
+        const QString name = proxy->data(table->selectionModel()->selectedRows(ProcessModel::Name).first()).toString();
+        if (QMessageBox::question(this, "Confirm",
+                QString("Send %1 to %2 (PID %3)?").arg(sig == SIGKILL ? "SIGKILL" : "SIGTERM", name).arg(pid))
+            != QMessageBox::Yes) return;
+        if (::kill(pid, sig) != 0) {
+            if (errno == EPERM)
+                runInTerminal(QString("kill -%1 %2").arg(sig == SIGKILL ? "KILL" : "TERM").arg(pid), this, "Stopping process...");
+            else
+                QMessageBox::warning(this, "Signal", QString("Could not signal %1: %2").arg(pid).arg(strerror(errno)));
+        }
+        refresh();
+    }
+
+    ProcessScanner scanner;
+    ProcessModel *model;
+    QSortFilterProxyModel *proxy;
+    QTableView *table;
+    QLineEdit *filterEdit;
+    QLabel *statusLabel;
+    QTimer timer;
+};
+
+class SensorMonitor {
+public:
+    enum Kind { Temperature, Fan, Frequency };
+
+    struct Sensor {
+        QString chip;
+        QString label;
+        Kind kind = Temperature;
+        double value = 0;
+        double limit = 0;
+        int fd = -1;
+        int cpu = -1;
+    };
+
+    struct Throttle {
+        double load = 0;
+        double averageMhz = 0;
+        double maxMhz = 0;
+        bool throttled = false;
+        QString reason;
+    };
+
+    // Everything is discovered once; afterwards a poll is one pread per
+    // input on descriptors that stay open.
+    SensorMonitor() {
+        enumerateHwmon();
+        enumerateThermal();
+        enumerateCpufreq();
+        statFd = ::open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    }
+
+    ~SensorMonitor() {
+        for (const Sensor &s : std::as_const(sensorList)) ::close(s.fd);
+        for (int fd : std::as_const(throttleFds)) ::close(fd);
+        if (statFd >= 0) ::close(statFd);
+    }
+
+    SensorMonitor(const SensorMonitor &) = delete;
+    SensorMonitor &operator=(const SensorMonitor &) = delete;
+
+    const QList<Sensor> &sensors() const { return sensorList; }
+
+    Throttle poll() {
+        double freqSum = 0, maxSum = 0;
+        int freqCount = 0;
+        for (Sensor &s : sensorList) {
+            const qint64 raw = readNumber(s.fd);
+            if (raw < 0) continue;
+            switch (s.kind) {
+            case Temperature: s.value = raw / 1000.0; break;
+            case Fan: s.value = raw; break;
+            case Frequency:
+                s.value = raw / 1000.0;
+                freqSum += s.value;
+                maxSum += s.limit;
+                ++freqCount;
+                break;
+            }
+        }
+
+        Throttle t;
+        t.load = cpuLoad();
+        if (freqCount > 0) {
+            t.averageMhz = freqSum / freqCount;
+            t.maxMhz = maxSum / freqCount;
+        }
+
+        qint64 events = 0;
+        for (int fd : std::as_const(throttleFds)) events += qMax<qint64>(0, readNumber(fd));
+        const qint64 newEvents = lastThrottleEvents >= 0 ? events - lastThrottleEvents : 0;
+        lastThrottleEvents = events;
+
+        // Low clocks while idle are just power saving; only a busy CPU
+        // running well under its rated maximum counts as throttled.
+        if (newEvents > 0) {
+            t.throttled = true;
+            t.reason = QString("%1 thermal throttle events").arg(newEvents);
+        } else if (t.load > 0.8 && t.maxMhz > 0 && t.averageMhz < 0.7 * t.maxMhz) {
+            t.throttled = true;
+            t.reason = QString("busy CPU at %1% of its maximum clock").arg(qRound(100 * t.averageMhz / t.maxMhz));
+        }
+        return t;
+    }
+
+private:
+    static qint64 readNumber(int fd) {
+        char buf[32];
+        const ssize_t n = ::pread(fd, buf, sizeof(buf) - 1, 0);
+        if (n <= 0) return -1;
+        buf[n] = '\0';
+        return std::strtoll(buf, nullptr, 10);
+    }
+
+    static QString readText(const QString &path) {
+        QFile f(path);
+        return f.open(QIODevice::ReadOnly) ? QString::fromUtf8(f.readAll().trimmed()) : QString();
+    }
+
+    void add(Sensor s, const QString &path) {
+        s.fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+        if (s.fd >= 0 && readNumber(s.fd) >= 0) sensorList.append(s);
+        else if (s.fd >= 0) ::close(s.fd);
+    }
+
+    void enumerateHwmon() {
+        QDir root("/sys/class/hwmon");
+        for (const QString &entry : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+            const QString dir = root.filePath(entry);
+            const QString chip = readText(dir + "/name");
+            const QStringList inputs = QDir(dir).entryList({"temp*_input", "fan*_input"}, QDir::Files, QDir::Name);
+            for (const QString &input : inputs) {
+                const QString base = input.left(input.indexOf('_'));
+                Sensor s;
+                s.chip = chip.isEmpty() ? entry : chip;
+                s.kind = base.startsWith("temp") ? Temperature : Fan;
+                s.label = readText(dir + "/" + base + "_label");
+                if (s.label.isEmpty()) s.label = base;
+                if (s.kind == Temperature) {
+                    QString crit = readText(dir + "/" + base + "_crit");
+                    if (crit.isEmpty()) crit = readText(dir + "/" + base + "_max");
+                    s.limit = crit.toDouble() / 1000.0;
+                }
+                add(s, dir + "/" + input);
+            }
+        }
+    }
+
+    void enumerateThermal() {
+        QDir root("/sys/class/thermal");
+        for (const QString &entry : root.entryList({"thermal_zone*"}, QDir::Dirs, QDir::Name)) {
+            const QString dir = root.filePath(entry);
+            Sensor s;
+            s.chip = "thermal";
+            s.label = readText(dir + "/type");
+            if (s.label.isEmpty()) s.label = entry;
+            for (int trip = 0; QFileInfo::exists(dir + QString("/trip_point_%1_type").arg(trip)); ++trip) {
+                if (readText(dir + QString("/trip_point_%1_type").arg(trip)) == "critical") {
+                    s.limit = readText(dir + QString("/trip_point_%1_temp").arg(trip)).toDouble() / 1000.0;
+                    break;
+                }
+            }
+            add(s, dir + "/temp");
+        }
+    }
+
+    void enumerateCpufreq() {
+        QDir root("/sys/devices/system/cpu");
+        QStringList cpus = root.entryList({"cpu[0-9]*"}, QDir::Dirs);
+        std::sort(cpus.begin(), cpus.end(), [](const QString &a, const QString &b) {
+            return a.mid(3).toInt() < b.mid(3).toInt();
+        });
+        for (const QString &cpu : std::as_const(cpus)) {
+            const QString dir = root.filePath(cpu);
+            Sensor s;
+            s.chip = "cpufreq";
+            s.label = cpu;
+            s.kind = Frequency;
+            s.cpu = cpu.mid(3).toInt();
+            s.limit = readText(dir + "/cpufreq/cpuinfo_max_freq").toDouble() / 1000.0;
+            add(s, dir + "/cpufreq/scaling_cur_freq");
+
+            const QByteArray throttle = QFile::encodeName(dir + "/thermal_throttle/core_throttle_count");
+            const int fd = ::open(throttle.constData(), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) throttleFds.append(fd);
+        }
+    }
+
+    double cpuLoad() {
+        char buf[256];
+        const ssize_t n = statFd >= 0 ? ::pread(statFd, buf, sizeof(buf) - 1, 0) : -1;
+        if (n <= 0) return 0;
+        buf[n] = '\0';
+        quint64 total = 0, idle = 0;
+        const char *p = buf + 3;
+        for (int i = 1; i <= 8; ++i) {
+            char *next = nullptr;
+            const quint64 v = std::strtoull(p, &next, 10);
+            if (next == p) break;
+            total += v;
+            if (i == 4 || i == 5) idle += v;
+            p = next;
+        }
+        const quint64 dTotal = total - lastTotal, dIdle = idle - lastIdle;
+        const bool first = lastTotal == 0;
+        lastTotal = total;
+        lastIdle = idle;
+        return first || dTotal == 0 ? 0 : double(dTotal - dIdle) / dTotal;
+    }
+
+    QList<Sensor> sensorList;
+    QList<int> throttleFds;
+    int statFd = -1;
+    quint64 lastTotal = 0;
+    quint64 lastIdle = 0;
+    qint64 lastThrottleEvents = -1;
+};
+
+class SensorPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit SensorPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Sensors");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        statusLabel = new QLabel;
+        statusLabel->setProperty("class", "smallText");
+        statusLabel->setWordWrap(true);
+        layout->addWidget(statusLabel);
+
+        tree = new QTreeWidget;
+        tree->setColumnCount(3);
+        tree->setHeaderLabels({"Sensor", "Value", "Limit"});
+        tree->setRootIsDecorated(true);
+        tree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(tree);
+
+        QHash<QString, QTreeWidgetItem *> chips;
+        for (const auto &s : monitor.sensors()) {
+            QTreeWidgetItem *&chip = chips[s.chip];
+            if (!chip) {
+                chip = new QTreeWidgetItem(tree, {s.chip});
+                chip->setExpanded(s.kind != SensorMonitor::Frequency);
+            }
+            auto item = new QTreeWidgetItem(chip, {s.label, QString(), s.limit > 0 ? format(s.kind, s.limit) : QString()});
+            item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+            item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+            items.append(item);
+        }
+        if (items.isEmpty())
+            statusLabel->setText("No hwmon, thermal or cpufreq sensors are exposed on this system.");
+
+        connect(&timer, &QTimer::timeout, this, &SensorPanel::refresh);
+        timer.setInterval(1000);
+    }
+
+protected:
+    void showEvent(QShowEvent *event) override {
+        refresh();
+        timer.start();
+        QWidget::showEvent(event);
+    }
+
+    void hideEvent(QHideEvent *event) override {
+        timer.stop();
+        QWidget::hideEvent(event);
+    }
+
+private slots:
+    void refresh() {
+        if (items.isEmpty()) return;
+        const SensorMonitor::Throttle t = monitor.poll();
+        const QList<SensorMonitor::Sensor> &sensors = monitor.sensors();
+        for (qsizetype i = 0; i < sensors.size(); ++i)
+            items[i]->setText(1, format(sensors[i].kind, sensors[i].value));
+
+        QString text = QString("CPU load %1%").arg(qRound(100 * t.load));
+        if (t.maxMhz > 0)
+            text += QString(", average clock %1 of %2 MHz").arg(qRound(t.averageMhz)).arg(qRound(t.maxMhz));
+        if (t.throttled) text += "\nThrottling: " + t.reason;
+        statusLabel->setText(text);
+        if (statusLabel->property("warning").toBool() != t.throttled)
+            Theme::setState(statusLabel, "warning", t.throttled);
+    }
+
+private:
+    static QString format(SensorMonitor::Kind kind, double value) {
+        switch (kind) {
+        case SensorMonitor::Temperature: return QString::number(value, 'f', 1) + " °C";
+        case SensorMonitor::Fan: return QString::number(qRound(value)) + " RPM";
+        case SensorMonitor::Frequency: return QString::number(qRound(value)) + " MHz";
+        }
+        return QString();
+    }
+
+    SensorMonitor monitor;
+    QTreeWidget *tree;
+    QLabel *statusLabel;
+    QList<QTreeWidgetItem *> items;
+    QTimer timer;
+};
+
+class SystemTuning {
+public:
+    enum Profile { DesktopLatency, Throughput, Battery };
+
+    struct State {
+        QString governor;
+        QString epp;
+        int swappiness = -1;
+        int cachePressure = -1;
+        QString thp;
+        QMap<QString, QString> schedulers;
+    };
+
+    static QString cpufreqPath(const QString &file) { return "/sys/devices/system/cpu/cpu0/cpufreq/" + file; }
+    static QString thpPath() { return "/sys/kernel/mm/transparent_hugepage/enabled"; }
+    static QString schedulerPath(const QString &disk) { return "/sys/block/" + disk + "/queue/scheduler"; }
+
+    static QString readValue(const QString &path) {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) return QString();
+        return QString::fromUtf8(f.readAll().trimmed());
+    }
+
+    // Files such as "always [madvise] never" list the choices and bracket
+    // the active one; plain lists have no selection.
+    static QStringList options(const QString &path) {
+        return readValue(path).remove('[').remove(']').split(' ', Qt::SkipEmptyParts);
+    }
+
+    static QString selected(const QString &path) {
+        const QString text = readValue(path);
+        const qsizetype open = text.indexOf('['), close = text.indexOf(']');
+        return open >= 0 && close > open ? text.mid(open + 1, close - open - 1) : text;
+    }
+
+    static QStringList disks() {
+        QStringList list;
+        for (const QString &disk : QDir("/sys/block").entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+            if (disk.startsWith("loop") || disk.startsWith("ram") || disk.startsWith("zram")) continue;
+            if (options(schedulerPath(disk)).size() > 1) list << disk;
+        }
+        return list;
+    }
+
+    static bool rotational(const QString &disk) {
+        return readValue("/sys/block/" + disk + "/queue/rotational") == "1";
+    }
+
+    static State current() {
+        State s;
+        s.governor = readValue(cpufreqPath("scaling_governor"));
+        s.epp = readValue(cpufreqPath("energy_performance_preference"));
+        bool ok = false;
+        const int swappiness = readValue("/proc/sys/vm/swappiness").toInt(&ok);
+        if (ok) s.swappiness = swappiness;
+        const int pressure = readValue("/proc/sys/vm/vfs_cache_pressure").toInt(&ok);
+        if (ok) s.cachePressure = pressure;
+        s.thp = selected(thpPath());
+        for (const QString &disk : disks()) s.schedulers.insert(disk, selected(schedulerPath(disk)));
+        return s;
+    }
+
+    static State profile(Profile p) {
+        const QStringList governors = options(cpufreqPath("scaling_available_governors"));
+        const QStringList epps = options(cpufreqPath("energy_performance_available_preferences"));
+        auto pick = [](const QStringList &available, const QStringList &wanted) {
+            for (const QString &w : wanted)
+                if (available.contains(w)) return w;
+            return QString();
+        };
+        // intel_pstate and amd-pstate-epp in active mode only offer
+        // performance and powersave, and "powersave" there means "follow the
+        // EPP hint"; the performance governor rejects any other EPP value.
+        const bool eppDriver = QFile::exists(cpufreqPath("energy_performance_preference")) && governors.contains("powersave");
+
+        State s;
+        switch (p) {
+        case DesktopLatency:
+            s.governor = eppDriver ? QString("powersave") : pick(governors, {"schedutil", "ondemand", "performance"});
+            s.epp = pick(epps, {"balance_performance", "default"});
+            s.swappiness = 10;
+            s.cachePressure = 50;
+            s.thp = "madvise";
+            break;
+        case Throughput:
+            s.governor = pick(governors, {"performance"});
+            s.epp = pick(epps, {"performance"});
+            s.swappiness = 10;
+            s.cachePressure = 100;
+            s.thp = "always";
+            break;
+        case Battery:
+            s.governor = eppDriver ? QString("powersave") : pick(governors, {"schedutil", "conservative"});
+            s.epp = pick(epps, {"power", "balance_power"});
+            s.swappiness = 60;
+            s.cachePressure = 100;
+            s.thp = "madvise";
+            break;
+        }
+        for (const QString &disk : disks()) {
+            const QStringList available = options(schedulerPath(disk));
+            const bool nvme = disk.startsWith("nvme");
+            QStringList wanted;
+            if (rotational(disk)) wanted = {"bfq", "mq-deadline"};
+            else if (p == Battery) wanted = {"mq-deadline", "none"};
+            else wanted = nvme ? QStringList{"none", "mq-deadline"} : QStringList{"mq-deadline", "none"};
+            const QString choice = pick(available, wanted);
+            if (!choice.isEmpty()) s.schedulers.insert(disk, choice);
+        }
+        return s;
+    }
+
+    // The script applies every live value first and only then replaces the
+    // persisted sysctl.d, tmpfiles.d and udev files (saving the old ones).
+    // Any failed write restores the previous live values and files.
+    static QString script(const State &target, const State &previous) {
+        QStringList apply, undo;
+        auto live = [&](QStringList &out, const QString &glob, const QString &value) {
+            if (!value.isEmpty())
+                out << QString("for f in %1; do w \"$f\" %2; done").arg(glob, quote(value));
+        };
+        auto both = [&](const QString &glob, const QString &value, const QString &old) {
+            live(apply, glob, value);
+            live(undo, glob, old);
+        };
+        both("/sys/devices/system/cpu/cpu[0-9]*/cpufreq/scaling_governor", target.governor, previous.governor);
+        both("/sys/devices/system/cpu/cpu[0-9]*/cpufreq/energy_performance_preference", target.epp, previous.epp);
+        both("/proc/sys/vm/swappiness", number(target.swappiness), number(previous.swappiness));
+        both("/proc/sys/vm/vfs_cache_pressure", number(target.cachePressure), number(previous.cachePressure));
+        both(thpPath(), target.thp, previous.thp);
+        for (auto it = target.schedulers.begin(); it != target.schedulers.end(); ++it)
+            both(schedulerPath(it.key()), it.value(), previous.schedulers.value(it.key()));
+
+        QStringList sysctl, tmpfiles, udev;
+        if (target.swappiness >= 0) sysctl << QString("vm.swappiness = %1").arg(target.swappiness);
+        if (target.cachePressure >= 0) sysctl << QString("vm.vfs_cache_pressure = %1").arg(target.cachePressure);
+        if (!target.thp.isEmpty()) tmpfiles << QString("w %1 - - - - %2").arg(thpPath(), target.thp);
+        if (!target.governor.isEmpty())
+            tmpfiles << "w /sys/devices/system/cpu/cpu*/cpufreq/scaling_governor - - - - " + target.governor;
+        if (!target.epp.isEmpty())
+            tmpfiles << "w /sys/devices/system/cpu/cpu*/cpufreq/energy_performance_preference - - - - " + target.epp;
+        for (auto it = target.schedulers.begin(); it != target.schedulers.end(); ++it)
+            udev << QString("ACTION==\"add|change\", KERNEL==\"%1\", ATTR{queue/scheduler}=\"%2\"").arg(it.key(), it.value());
+
+        QString s;
+        s += "set -u\n";
+        s += "backup=$(mktemp -d /tmp/err_-tuning-XXXXXX)\n";
+        // rollback() finishes before it exits, so the copies outlive any use.
+        // This replaces the runner's trap, so it removes the script as well.
+        s += "trap 'rm -rf \"$backup\"; rm -f \"$0\"' EXIT\n";
+        s += "files='" + persistedFiles().join(' ') + "'\n";
+        s += "for f in $files; do [ -e \"$f\" ] && cp -p \"$f\" \"$backup/$(basename \"$f\")\"; done\n";
+        s += "rollback() {\n"
+             "    echo \"Tuning failed, restoring the previous settings\"\n"
+             "    w() { printf '%s' \"$2\" > \"$1\" 2>/dev/null; }\n";
+        for (const QString &line : std::as_const(undo)) s += "    " + line + "\n";
+        s += "    for f in $files; do\n"
+             "        if [ -e \"$backup/$(basename \"$f\")\" ]; then cp -p \"$backup/$(basename \"$f\")\" \"$f\"; else rm -f \"$f\"; fi\n"
+             "    done\n"
+             "    exit 1\n"
+             "}\n";
+        s += "w() { printf '%s' \"$2\" > \"$1\" || rollback; }\n";
+        s += "put() { mkdir -p \"$(dirname \"$1\")\" && printf '%s\\n' \"$2\" > \"$1.err_new\" && mv \"$1.err_new\" \"$1\" || rollback; }\n";
+        for (const QString &line : std::as_const(apply)) s += line + "\n";
+        s += "put /etc/sysctl.d/90-err_-tuning.conf " + quote(sysctl.join('\n')) + "\n";
+        s += "put /etc/tmpfiles.d/err_-tuning.conf " + quote(tmpfiles.join('\n')) + "\n";
+        s += "put /etc/udev/rules.d/60-err_-iosched.rules " + quote(udev.join('\n')) + "\n";
+        s += "echo \"Tuning applied and persisted.\"\n";
+        return s;
+    }
+
+    static QString resetScript() {
+        return "rm -f " + persistedFiles().join(' ') + " && echo \"Persisted tuning removed; defaults return on the next boot.\"\n";
+    }
+
+private:
+    static QStringList persistedFiles() {
+        return {"/etc/sysctl.d/90-err_-tuning.conf", "/etc/tmpfiles.d/err_-tuning.conf", "/etc/udev/rules.d/60-err_-iosched.rules"};
+    }
+
+    static QString number(int value) { return value >= 0 ? QString::number(value) : QString(); }
+
+    static QString quote(QString value) {
+        return "'" + value.replace("'", "'\\''") + "'";
+    }
+};
+
+class TuningPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit TuningPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto outer = new QVBoxLayout(this);
+        auto scroll = new QScrollArea;
+        scroll->setWidgetResizable(true);
+        auto content = new QWidget;
+        auto layout = new QVBoxLayout(content);
+        scroll->setWidget(content);
+        outer->addWidget(scroll);
+
+        auto titleLabel = new QLabel("Performance Tuning");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        auto intro = new QLabel("Profiles are applied in one privileged step, rolled back if any write fails, "
+                                "and persisted through sysctl.d, tmpfiles.d and udev rules.");
+        intro->setWordWrap(true);
+        intro->setProperty("class", "smallText");
+        layout->addWidget(intro);
+
+        auto profileGroup = new QGroupBox("Profiles");
+        auto profileLayout = new QHBoxLayout(profileGroup);
+        const QList<QPair<QString, SystemTuning::Profile>> profiles = {
+            {"Desktop Latency", SystemTuning::DesktopLatency},
+            {"Throughput", SystemTuning::Throughput},
+            {"Battery", SystemTuning::Battery},
+        };
+        for (const auto &entry : profiles) {
+            const QString name = entry.first;
+            const SystemTuning::Profile profile = entry.second;
+            auto btn = new QPushButton(name);
+            btn->setProperty("class", "plainButton");
+            connect(btn, &QPushButton::clicked, this, [this, name, profile]() {
+                showState(SystemTuning::profile(profile));
+                apply(name + " profile");
+            });
+            profileLayout->addWidget(btn);
+        }
+        layout->addWidget(profileGroup);
+
+        auto customGroup = new QGroupBox("Custom");
+        form = new QFormLayout(customGroup);
+        governorCombo = new QComboBox;
+        governorCombo->addItems(SystemTuning::options(SystemTuning::cpufreqPath("scaling_available_governors")));
+        form->addRow("CPU governor:", governorCombo);
+        eppCombo = new QComboBox;
+        eppCombo->addItems(SystemTuning::options(SystemTuning::cpufreqPath("energy_performance_available_preferences")));
+        form->addRow("Energy preference:", eppCombo);
+        swappinessSpin = new QSpinBox;
+        swappinessSpin->setRange(0, 200);
+        form->addRow("vm.swappiness:", swappinessSpin);
+        pressureSpin = new QSpinBox;
+        pressureSpin->setRange(1, 1000);
+        form->addRow("vm.vfs_cache_pressure:", pressureSpin);
+        thpCombo = new QComboBox;
+        thpCombo->addItems(SystemTuning::options(SystemTuning::thpPath()));
+        form->addRow("Transparent hugepages:", thpCombo);
+        for (const QString &disk : SystemTuning::disks()) {
+            auto combo = new QComboBox;
+            combo->addItems(SystemTuning::options(SystemTuning::schedulerPath(disk)));
+            form->addRow(QString("%1 scheduler%2:").arg(disk, SystemTuning::rotational(disk) ? " (HDD)" : ""), combo);
+            schedulerCombos.insert(disk, combo);
+        }
+        governorCombo->setEnabled(governorCombo->count() > 0);
+        eppCombo->setEnabled(eppCombo->count() > 0);
+        thpCombo->setEnabled(thpCombo->count() > 0);
+        layout->addWidget(customGroup);
+
+        auto buttons = new QHBoxLayout;
+        auto applyBtn = new QPushButton(QIcon::fromTheme("dialog-ok-apply"), "Apply");
+        auto reloadBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Reload");
+        auto resetBtn = new QPushButton(QIcon::fromTheme("edit-undo"), "Remove Persisted Tuning");
+        for (auto btn : {applyBtn, reloadBtn, resetBtn}) {
+            btn->setProperty("class", "plainButton");
+            buttons->addWidget(btn);
+        }
+        layout->addLayout(buttons);
+        layout->addStretch();
+
+        connect(applyBtn, &QPushButton::clicked, this, [this]() { apply("custom settings"); });
+        connect(reloadBtn, &QPushButton::clicked, this, [this]() { showState(SystemTuning::current()); });
+        connect(resetBtn, &QPushButton::clicked, this, [this]() {
+            runScriptInTerminal(SystemTuning::resetScript(), this, "Removing persisted tuning...");
+        });
+
+        showState(SystemTuning::current());
+    }
+
+protected:
+    void showEvent(QShowEvent *event) override {
+        showState(SystemTuning::current());
+        QWidget::showEvent(event);
+    }
+
+private:
+    void showState(const SystemTuning::State &s) {
+        auto select = [](QComboBox *combo, const QString &value) {
+            const int i = combo->findText(value);
+            if (i >= 0) combo->setCurrentIndex(i);
+        };
+        select(governorCombo, s.governor);
+        select(eppCombo, s.epp);
+        if (s.swappiness >= 0) swappinessSpin->setValue(s.swappiness);
+        if (s.cachePressure >= 0) pressureSpin->setValue(s.cachePressure);
+        select(thpCombo, s.thp);
+        for (auto it = s.schedulers.begin(); it != s.schedulers.end(); ++it)
+            if (QComboBox *combo = schedulerCombos.value(it.key())) select(combo, it.value());
+    }
+
+    SystemTuning::State chosenState() const {
+        SystemTuning::State s;
+        if (governorCombo->isEnabled()) s.governor = governorCombo->currentText();
+        if (eppCombo->isEnabled()) s.epp = eppCombo->currentText();
+        s.swappiness = swappinessSpin->value();
+        s.cachePressure = pressureSpin->value();
+        if (thpCombo->isEnabled()) s.thp = thpCombo->currentText();
+        for (auto it = schedulerCombos.begin(); it != schedulerCombos.end(); ++it)
+            s.schedulers.insert(it.key(), it.value()->currentText());
+        return s;
+    }
+
+    void apply(const QString &what) {
+        if (QMessageBox::question(this, "Apply Tuning", QString("Apply and persist the %1?").arg(what)) != QMessageBox::Yes) {
+            showState(SystemTuning::current());
+            return;
+        }
+        runScriptInTerminal(SystemTuning::script(chosenState(), SystemTuning::current()), this, "Applying tuning...");
+    }
+
+    QFormLayout *form;
+    QComboBox *governorCombo;
+    QComboBox *eppCombo;
+    QSpinBox *swappinessSpin;
+    QSpinBox *pressureSpin;
+    QComboBox *thpCombo;
+    QMap<QString, QComboBox *> schedulerCombos;
+};
+
+class ZramManager {
+public:
+    struct Swap {
+        QString name;
+        QString type;
+        qint64 sizeKb = 0;
+        qint64 usedKb = 0;
+        int priority = 0;
+    };
+
+    struct Zram {
+        QString device;
+        QString algorithm;
+        qint64 diskSize = 0;
+        qint64 original = 0;
+        qint64 compressed = 0;
+        qint64 memUsed = 0;
+        double ratio() const { return compressed > 0 ? double(original) / compressed : 0; }
+        qint64 saved() const { return qMax<qint64>(0, original - memUsed); }
+    };
+
+    struct Config {
+        int sizeMb = 0;
+        QString algorithm;
+        int priority = 100;
+    };
+
+    static QList<Swap> swaps() {
+        QList<Swap> list;
+        QFile f("/proc/swaps");
+        if (!f.open(QIODevice::ReadOnly)) return list;
+        f.readLine();
+        while (!f.atEnd()) {
+            const QList<QByteArray> cols = f.readLine().simplified().split(' ');
+            if (cols.size() < 5) continue;
+            list.append({QString::fromUtf8(cols[0]), QString::fromUtf8(cols[1]),
+                         cols[2].toLongLong(), cols[3].toLongLong(), cols[4].toInt()});
+        }
+        return list;
+    }
+
+    static QStringList devices() {
+        return QDir("/sys/block").entryList({"zram*"}, QDir::Dirs, QDir::Name);
+    }
+
+    // mm_stat: orig_data_size compr_data_size mem_used_total ...
+    static Zram stat(const QString &device) {
+        const QString dir = "/sys/block/" + device;
+        Zram z;
+        z.device = device;
+        z.algorithm = SystemTuning::selected(dir + "/comp_algorithm");
+        z.diskSize = SystemTuning::readValue(dir + "/disksize").toLongLong();
+        const QStringList mm = SystemTuning::readValue(dir + "/mm_stat").split(' ', Qt::SkipEmptyParts);
+        if (mm.size() >= 3) {
+            z.original = mm[0].toLongLong();
+            z.compressed = mm[1].toLongLong();
+            z.memUsed = mm[2].toLongLong();
+        }
+        return z;
+    }
+
+    static qint64 memTotalKb() {
+        QFile f("/proc/meminfo");
+        if (!f.open(QIODevice::ReadOnly)) return 0;
+        const QByteArray line = f.readLine();
+        return line.mid(line.indexOf(':') + 1).trimmed().split(' ').first().toLongLong();
+    }
+
+    static QStringList algorithms() {
+        for (const QString &device : devices()) {
+            const QStringList list = SystemTuning::options("/sys/block/" + device + "/comp_algorithm");
+            if (!list.isEmpty()) return list;
+        }
+        return {"zstd", "lz4", "lzo-rle"};
+    }
+
+    // Small machines get zram equal to RAM, since typical pages compress
+    // 3:1 or better; larger ones half of it, capped at 8 GiB.
+    static Config recommended() {
+        Config c;
+        const qint64 ramMb = memTotalKb() / 1024;
+        c.sizeMb = int(ramMb <= 4096 ? ramMb : qMin<qint64>(ramMb / 2, 8192));
+        const QStringList available = algorithms();
+        c.algorithm = available.contains("zstd") ? "zstd" : available.value(0, "lz4");
+        return c;
+    }
+
+    enum Backend { ZramGenerator, ZramTools, NoBackend };
+
+    static Backend backend() {
+        for (const char *path : {"/usr/lib/systemd/system-generators/zram-generator", "/lib/systemd/system-generators/zram-generator"})
+            if (QFileInfo::exists(path)) return ZramGenerator;
+        if (!QStandardPaths::findExecutable("zramswap", {"/usr/sbin", "/sbin", "/usr/bin"}).isEmpty()
+            || QFileInfo::exists("/etc/default/zramswap"))
+            return ZramTools;
+        return NoBackend;
+    }
+
+    // zram-generator is preferred and installed when neither backend is
+    // present; zram-tools is configured in place when it is what the
+    // system already uses.
+    static QString configureScript(const Config &c) {
+        QString s = "set -e\n";
+        if (backend() == ZramTools) {
+            s += "cp -p /etc/default/zramswap /etc/default/zramswap.err_bak 2>/dev/null || true\n";
+            s += QString("printf 'ALGO=%1\\nSIZE=%2\\nPRIORITY=%3\\n' > /etc/default/zramswap\n")
+                     .arg(c.algorithm).arg(c.sizeMb).arg(c.priority);
+            s += "systemctl restart zramswap.service\n";
+        } else {
+            if (backend() == NoBackend) s += "apt install -y systemd-zram-generator\n";
+            s += QString("printf '[zram0]\\nzram-size = %1\\ncompression-algorithm = %2\\nswap-priority = %3\\n' "
+                         "> /etc/systemd/zram-generator.conf\n").arg(c.sizeMb).arg(c.algorithm).arg(c.priority);
+            s += "systemctl daemon-reload\n";
+            s += "systemctl restart systemd-zram-setup@zram0.service\n";
+        }
+        s += "swapon --show\n";
+        return s;
+    }
+
+    static QString disableScript() {
+        if (backend() == ZramTools) return "systemctl disable --now zramswap.service\n";
+        return "rm -f /etc/systemd/zram-generator.conf\n"
+               "systemctl daemon-reload\n"
+               "systemctl stop systemd-zram-setup@zram0.service || true\n"
+               "swapon --show\n";
+    }
+};
+
+class MemoryPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit MemoryPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Memory & Swap");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        summaryLabel = new QLabel;
+        summaryLabel->setProperty("class", "smallText");
+        summaryLabel->setWordWrap(true);
+        layout->addWidget(summaryLabel);
+
+        swapTree = new QTreeWidget;
+        swapTree->setHeaderLabels({"Device", "Type", "Size", "Used", "Priority", "Compression"});
+        swapTree->setRootIsDecorated(false);
+        swapTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(swapTree);
+
+        auto configGroup = new QGroupBox("Compressed swap (zram)");
+        auto form = new QFormLayout(configGroup);
+        const ZramManager::Config rec = ZramManager::recommended();
+        sizeSpin = new QSpinBox;
+        sizeSpin->setRange(256, 65536);
+        sizeSpin->setSingleStep(256);
+        sizeSpin->setSuffix(" MiB");
+        sizeSpin->setValue(rec.sizeMb);
+        form->addRow("Size:", sizeSpin);
+        algoCombo = new QComboBox;
+        algoCombo->addItems(ZramManager::algorithms());
+        algoCombo->setCurrentText(rec.algorithm);
+        form->addRow("Algorithm:", algoCombo);
+        prioritySpin = new QSpinBox;
+        prioritySpin->setRange(-1, 32767);
+        prioritySpin->setValue(rec.priority);
+        form->addRow("Priority:", prioritySpin);
+
+        static const char *backends[] = {"zram-generator", "zram-tools", "none installed (zram-generator will be installed)"};
+        auto backendLabel = new QLabel(backends[ZramManager::backend()]);
+        backendLabel->setProperty("class", "smallText");
+        form->addRow("Backend:", backendLabel);
+
+        auto buttons = new QHBoxLayout;
+        auto applyBtn = new QPushButton(QIcon::fromTheme("dialog-ok-apply"), "Configure zram");
+        auto recommendBtn = new QPushButton(QIcon::fromTheme("help-hint"), "Use Recommended");
+        auto disableBtn = new QPushButton(QIcon::fromTheme("edit-delete"), "Disable zram");
+        for (auto btn : {applyBtn, recommendBtn, disableBtn}) {
+            btn->setProperty("class", "plainButton");
+            buttons->addWidget(btn);
+        }
+        form->addRow(buttons);
+        layout->addWidget(configGroup);
+
+        connect(recommendBtn, &QPushButton::clicked, this, [this]() {
+            const ZramManager::Config c = ZramManager::recommended();
+            sizeSpin->setValue(c.sizeMb);
+            algoCombo->setCurrentText(c.algorithm);
+            prioritySpin->setValue(c.priority);
+        });
+        connect(applyBtn, &QPushButton::clicked, this, [this]() {
+            ZramManager::Config c;
+            c.sizeMb = sizeSpin->value();
+            c.algorithm = algoCombo->currentText();
+            c.priority = prioritySpin->value();
+            runScriptInTerminal(ZramManager::configureScript(c), this, "Configuring zram swap...");
+        });
+        connect(disableBtn, &QPushButton::clicked, this, [this]() {
+            if (QMessageBox::question(this, "Disable zram", "Remove the zram swap configuration?") == QMessageBox::Yes)
+                runScriptInTerminal(ZramManager::disableScript(), this, "Disabling zram swap...");
+        });
+        connect(&timer, &QTimer::timeout, this, &MemoryPanel::refresh);
+        timer.setInterval(1000);
+    }
+
+protected:
+    void showEvent(QShowEvent *event) override {
+        refresh();
+        timer.start();
+        QWidget::showEvent(event);
+    }
+
+    void hideEvent(QHideEvent *event) override {
+        timer.stop();
+        QWidget::hideEvent(event);
+    }
+
+private slots:
+    void refresh() {
+        const QList<ZramManager::Swap> swaps = ZramManager::swaps();
+        QHash<QString, ZramManager::Zram> zrams;
+        for (const QString &device : ZramManager::devices()) zrams.insert("/dev/" + device, ZramManager::stat(device));
+
+        while (swapTree->topLevelItemCount() > swaps.size()) delete swapTree->takeTopLevelItem(swapTree->topLevelItemCount() - 1);
+        while (swapTree->topLevelItemCount() < swaps.size()) new QTreeWidgetItem(swapTree);
+
+        qint64 original = 0, saved = 0;
+        for (qsizetype i = 0; i < swaps.size(); ++i) {
+            const auto &s = swaps[i];
+            QTreeWidgetItem *item = swapTree->topLevelItem(i);
+            item->setText(0, s.name);
+            item->setText(1, s.type);
+            item->setText(2, formatBytes(qulonglong(s.sizeKb) * 1024));
+            item->setText(3, formatBytes(qulonglong(s.usedKb) * 1024));
+            item->setText(4, QString::number(s.priority));
+            if (zrams.contains(s.name)) {
+                const ZramManager::Zram z = zrams.value(s.name);
+                item->setText(5, z.original > 0
+                    ? QString("%1, %2:1, saves %3").arg(z.algorithm).arg(z.ratio(), 0, 'f', 2).arg(formatBytes(z.saved()))
+                    : z.algorithm);
+                original += z.original;
+                saved += z.saved();
+            } else {
+                item->setText(5, QString());
+            }
+        }
+
+        const qint64 ramMb = ZramManager::memTotalKb() / 1024;
+        QString text = QString("RAM: %1 MiB. ").arg(ramMb);
+        if (swaps.isEmpty()) text += "No swap is active.";
+        else if (zrams.isEmpty()) text += "Swap is disk-only; zram would avoid most swapping stalls.";
+        else text += QString("zram holds %1 and saves %2 of RAM.").arg(formatBytes(original), formatBytes(saved));
+        summaryLabel->setText(text);
+    }
+
+private:
+    QLabel *summaryLabel;
+    QTreeWidget *swapTree;
+    QSpinBox *sizeSpin;
+    QComboBox *algoCombo;
+    QSpinBox *prioritySpin;
+    QTimer timer;
+};
+
+class BootAnalyzer {
+public:
+    struct Unit {
+        QString name;
+        double seconds = 0;
+        double at = -1;
+    };
+
+    // systemd prints spans such as "1min 2.345s", "845ms" or "1h 2min".
+    static double parseDuration(const QString &text) {
+        static const QRegularExpression part("([0-9.]+)(h|min|s|ms|us|µs)");
+        double total = 0;
+        auto it = part.globalMatch(text);
+        while (it.hasNext()) {
+            const auto m = it.next();
+            const double v = m.captured(1).toDouble();
+            const QString unit = m.captured(2);
+            if (unit == "h") total += v * 3600;
+            else if (unit == "min") total += v * 60;
+            else if (unit == "s") total += v;
+            else if (unit == "ms") total += v / 1000;
+            else total += v / 1e6;
+        }
+        return total;
+    }
+
+    static QList<Unit> parseBlame(const QString &output) {
+        QList<Unit> list;
+        static const QRegularExpression line("^\\s*(.+?)\\s+(\\S+\\.(?:service|mount|socket|device|target|timer|swap|path|scope|slice))\\s*$");
+        for (const QString &l : output.split('\n', Qt::SkipEmptyParts)) {
+            const auto m = line.match(l);
+            if (m.hasMatch()) list.append({m.captured(2), parseDuration(m.captured(1))});
+        }
+        return list;
+    }
+
+    // critical-chain rows look like "  └─foo.service @3.402s +1.210s";
+    // "@" is when the unit became active, "+" how long it took to start.
+    static QList<Unit> parseCriticalChain(const QString &output) {
+        QList<Unit> list;
+        static const QRegularExpression line("([\\w@:.\\\\-]+\\.\\w+)\\s+@([^+]+?)(?:\\s+\\+(.+))?\\s*$");
+        for (const QString &l : output.split('\n', Qt::SkipEmptyParts)) {
+            const auto m = line.match(l);
+            if (!m.hasMatch()) continue;
+            Unit u;
+            u.name = m.captured(1);
+            const double active = parseDuration(m.captured(2));
+            u.seconds = m.captured(3).isEmpty() ? 0 : parseDuration(m.captured(3));
+            u.at = active - u.seconds;
+            list.append(u);
+        }
+        std::sort(list.begin(), list.end(), [](const Unit &a, const Unit &b) { return a.at < b.at; });
+        return list;
+    }
+};
+
+class BootTimeline : public QWidget {
+public:
+    explicit BootTimeline(QWidget *parent = nullptr) : QWidget(parent) {}
+
+    void setChain(const QList<BootAnalyzer::Unit> &units) {
+        chain = units;
+        total = 0;
+        for (const auto &u : chain) total = qMax(total, u.at + u.seconds);
+        setMinimumHeight(int(chain.size() + 1) * rowHeight + 8);
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override {
+        QPainter p(this);
+        p.fillRect(rect(), QColor("#0d0d0d"));
+        if (chain.isEmpty() || total <= 0) {
+            p.setPen(QColor("#9ca0b0"));
+            p.drawText(rect(), Qt::AlignCenter, "No critical chain available");
+            return;
+        }
+        const int labelWidth = qMin(260, width() / 3);
+        const double scale = (width() - labelWidth - 70) / total;
+        for (qsizetype i = 0; i < chain.size(); ++i) {
+            const auto &u = chain[i];
+            const int y = 4 + int(i) * rowHeight;
+            p.setPen(QColor("#dfe2ec"));
+            p.drawText(QRect(4, y, labelWidth - 8, rowHeight), Qt::AlignVCenter | Qt::AlignLeft,
+                       fontMetrics().elidedText(u.name, Qt::ElideMiddle, labelWidth - 8));
+            const QRectF bar(labelWidth + u.at * scale, y + 3, qMax(2.0, u.seconds * scale), rowHeight - 6);
+            p.fillRect(bar, u.seconds >= 1.0 ? QColor("#ff5555") : QColor("#1a3cff"));
+            p.setPen(QColor("#9ca0b0"));
+            p.drawText(QRectF(bar.right() + 4, y, 66, rowHeight), Qt::AlignVCenter | Qt::AlignLeft,
+                       QString("@%1s").arg(u.at + u.seconds, 0, 'f', 1));
+        }
+    }
+
+private:
+    static constexpr int rowHeight = 20;
+    QList<BootAnalyzer::Unit> chain;
+    double total = 0;
+};
+
+class BootPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit BootPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Boot Analysis");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        summaryLabel = new QLabel("Analysing the last boot...");
+        summaryLabel->setProperty("class", "smallText");
+        summaryLabel->setWordWrap(true);
+        layout->addWidget(summaryLabel);
+
+        auto tabs = new QTabWidget;
+        blameTree = new QTreeWidget;
+        blameTree->setHeaderLabels({"Unit", "Startup time"});
+        blameTree->setRootIsDecorated(false);
+        blameTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        tabs->addTab(blameTree, "Slowest Units");
+
+        timeline = new BootTimeline;
+        auto timelineScroll = new QScrollArea;
+        timelineScroll->setWidgetResizable(true);
+        timelineScroll->setWidget(timeline);
+        tabs->addTab(timelineScroll, "Critical Path");
+        layout->addWidget(tabs, 1);
+
+        auto buttons = new QHBoxLayout;
+        auto disableBtn = new QPushButton(QIcon::fromTheme("media-playback-pause"), "Disable");
+        auto maskBtn = new QPushButton(QIcon::fromTheme("dialog-cancel"), "Mask");
+        auto unmaskBtn = new QPushButton(QIcon::fromTheme("edit-undo"), "Unmask / Enable");
+        auto refreshBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Refresh");
+        for (auto btn : {disableBtn, maskBtn, unmaskBtn, refreshBtn}) {
+            btn->setProperty("class", "plainButton");
+            buttons->addWidget(btn);
+        }
+        layout->addLayout(buttons);
+
+        connect(disableBtn, &QPushButton::clicked, this, [this]() { unitAction("disable", "Disabling unit..."); });
+        connect(maskBtn, &QPushButton::clicked, this, [this]() { unitAction("mask", "Masking unit..."); });
+        connect(unmaskBtn, &QPushButton::clicked, this, [this]() {
+            const QString unit = selectedUnit();
+            if (unit.isEmpty()) return;
+            const QString quoted = "'" + QString(unit).replace("'", "'\\''") + "'";
+            runScriptInTerminal(QString("set -e\nsystemctl unmask %1\nsystemctl enable %1\n").arg(quoted), this, "Re-enabling unit...");
+        });
+        connect(refreshBtn, &QPushButton::clicked, this, &BootPanel::analyse);
+    }
+
+protected:
+    // systemd-analyze is only run once the tab is first opened.
+    void showEvent(QShowEvent *event) override {
+        if (!analysed) analyse();
+        QWidget::showEvent(event);
+    }
+
+private slots:
+    void analyse() {
+        analysed = true;
+        if (QStandardPaths::findExecutable("systemd-analyze").isEmpty()) {
+            summaryLabel->setText("systemd-analyze is not available on this system.");
+            return;
+        }
+        summaryLabel->setText("Analysing the last boot...");
+        run({"time"}, [this](const QString &out) {
+            summaryLabel->setText(out.section('\n', 0, 0).trimmed());
+        });
+        run({"blame"}, [this](const QString &out) {
+            blameTree->clear();
+            for (const auto &u : BootAnalyzer::parseBlame(out)) {
+                auto item = new QTreeWidgetItem(blameTree, {u.name, QString::number(u.seconds, 'f', 3) + " s"});
+                item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+            }
+        });
+        run({"critical-chain"}, [this](const QString &out) {
+            timeline->setChain(BootAnalyzer::parseCriticalChain(out));
+        });
+    }
+
+private:
+    void run(const QStringList &args, std::function<void(const QString &)> done) {
+        auto proc = new QProcess(this);
+        connect(proc, &QProcess::finished, this, [proc, done]() {
+            done(QString::fromUtf8(proc->readAllStandardOutput()));
+            proc->deleteLater();
+        });
+        connect(proc, &QProcess::errorOccurred, proc, [proc](QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart) proc->deleteLater();
+        });
+        proc->start("systemd-analyze", QStringList(args) << "--no-pager");
+    }
+
+    QString selectedUnit() const {
+        QTreeWidgetItem *item = blameTree->currentItem();
+        return item ? item->text(0) : QString();
+    }
+
+    void unitAction(const QString &verb, const QString &desc) {
+        const QString unit = selectedUnit();
+        if (unit.isEmpty()) {
+            QMessageBox::information(this, "Boot", "Select a unit in the Slowest Units list first.");
+            return;
+        }
+        if (QMessageBox::question(this, "Confirm", QString("%1 %2?\nIt will not start on the next boot.").arg(verb, unit))
+            != QMessageBox::Yes) return;
+        runInTerminal(QString("systemctl %1 %2").arg(verb, unit), this, desc);
+    }
+
+    QLabel *summaryLabel;
+    QTreeWidget *blameTree;
+    BootTimeline *timeline;
+    bool analysed = false;
+};
+
+class LogStore {
+public:
+    struct Entry {
+        qint64 timeUs = 0;
+        quint8 priority = 6;
+        quint16 unit = 0;
+        QString message;
+    };
+
+    struct Filter {
+        int maxPriority = 7;
+        int unit = -1;
+        qint64 sinceUs = 0;
+        QString text;
+    };
+
+    explicit LogStore(qsizetype capacity = 100000) : ring(capacity) {
+        unitId("(none)");
+    }
+
+    quint64 append(Entry entry) {
+        const quint64 seq = next++;
+        byPriority[qMin<int>(entry.priority, 7)].push_back(seq);
+        byUnit[entry.unit].push_back(seq);
+        byMinute[entry.timeUs / 60000000].push_back(seq);
+        ring[seq % ring.size()] = std::move(entry);
+        if (seq % 4096 == 0) prune();
+        return seq;
+    }
+
+    quint16 unitId(const QString &name) {
+        auto it = unitIds.constFind(name);
+        if (it != unitIds.constEnd()) return *it;
+        if (unitNames.size() >= std::numeric_limits<quint16>::max()) return 0;
+        const quint16 id = quint16(unitNames.size());
+        unitNames << name;
+        unitIds.insert(name, id);
+        byUnit.emplace_back();
+        return id;
+    }
+
+    const QStringList &units() const { return unitNames; }
+    quint64 firstSeq() const { return next > ring.size() ? next - ring.size() : 0; }
+    quint64 endSeq() const { return next; }
+    const Entry &at(quint64 seq) const { return ring[seq % ring.size()]; }
+
+    bool matches(quint64 seq, const Filter &f) const {
+        const Entry &e = at(seq);
+        return e.priority <= f.maxPriority && (f.unit < 0 || e.unit == f.unit) && e.timeUs >= f.sinceUs
+            && (f.text.isEmpty() || e.message.contains(f.text, Qt::CaseInsensitive));
+    }
+
+    // The narrowest index (unit, priority or minute buckets) supplies the
+    // candidates and only those are checked against the full filter.
+    std::vector<quint64> query(const Filter &f) const {
+        const quint64 first = firstSeq();
+        std::vector<quint64> out;
+        auto take = [&](const std::deque<quint64> &list) {
+            for (auto it = std::lower_bound(list.begin(), list.end(), first); it != list.end(); ++it)
+                if (matches(*it, f)) out.push_back(*it);
+        };
+
+        size_t best = next - first;
+        enum { All, Unit, Priority, Time } source = All;
+        if (f.unit >= 0 && size_t(f.unit) < byUnit.size() && byUnit[f.unit].size() < best) {
+            best = byUnit[f.unit].size();
+            source = Unit;
+        }
+        if (f.maxPriority < 7) {
+            size_t count = 0;
+            for (int p = 0; p <= f.maxPriority; ++p) count += byPriority[p].size();
+            if (count < best) {
+                best = count;
+                source = Priority;
+            }
+        }
+        auto since = byMinute.lower_bound(f.sinceUs / 60000000);
+        if (f.sinceUs > 0) {
+            size_t count = 0;
+            for (auto it = since; it != byMinute.end() && count < best; ++it) count += it->second.size();
+            if (count < best) source = Time;
+        }
+
+        switch (source) {
+        case Unit:
+            take(byUnit[f.unit]);
+            break;
+        case Priority:
+            for (int p = 0; p <= f.maxPriority; ++p) take(byPriority[p]);
+            std::sort(out.begin(), out.end());
+            break;
+        case Time:
+            for (auto it = since; it != byMinute.end(); ++it) take(it->second);
+            std::sort(out.begin(), out.end());
+            break;
+        case All:
+            for (quint64 seq = first; seq < next; ++seq)
+                if (matches(seq, f)) out.push_back(seq);
+            break;
+        }
+        return out;
+    }
+
+private:
+    // Index entries that fell out of the ring are dropped in batches.
+    void prune() {
+        const quint64 first = firstSeq();
+        auto trim = [first](std::deque<quint64> &list) {
+            while (!list.empty() && list.front() < first) list.pop_front();
+        };
+        for (auto &list : byPriority) trim(list);
+        for (auto &list : byUnit) trim(list);
+        for (auto it = byMinute.begin(); it != byMinute.end();) {
+            trim(it->second);
+            it = it->second.empty() ? byMinute.erase(it) : std::next(it);
+        }
+    }
+
+    std::vector<Entry> ring;
+    quint64 next = 0;
+    std::array<std::deque<quint64>, 8> byPriority;
+    std::vector<std::deque<quint64>> byUnit;
+    std::map<qint64, std::deque<quint64>> byMinute;
+    QStringList unitNames;
+    QHash<QString, quint16> unitIds;
+};
+
+class LogCollector : public QObject {
+    Q_OBJECT
+public:
+    explicit LogCollector(LogStore *store, QObject *parent = nullptr) : QObject(parent), store(store) {}
+
+    ~LogCollector() override {
+        if (journal && journal->state() != QProcess::NotRunning) {
+            journal->kill();
+            journal->waitForFinished(1000);
+        }
+    }
+
+    void start() {
+        for (const QFileInfo &file : QDir("/var/log").entryInfoList({"*.log"}, QDir::Files | QDir::Readable, QDir::Name)) {
+            // Only the recent tail of each file is loaded up front.
+            offsets.insert(file.absoluteFilePath(), tailOffset(file.absoluteFilePath(), file.size()));
+        }
+        pollFiles();
+        connect(&filePoll, &QTimer::timeout, this, &LogCollector::pollFiles);
+        filePoll.start(1000);
+
+        if (QStandardPaths::findExecutable("journalctl").isEmpty()) return;
+        journal = new QProcess(this);
+        connect(journal, &QProcess::readyReadStandardOutput, this, &LogCollector::readJournal);
+        journal->start("journalctl", {"-o", "json", "--follow", "--no-pager", "-n", "20000"});
+    }
+
+signals:
+    void appended(quint64 from, quint64 to);
+
+private slots:
+    void readJournal() {
+        const quint64 from = store->endSeq();
+        while (journal->canReadLine()) {
+            const QJsonObject o = QJsonDocument::fromJson(journal->readLine()).object();
+            if (o.isEmpty()) continue;
+            LogStore::Entry e;
+            e.timeUs = o.value("__REALTIME_TIMESTAMP").toString().toLongLong();
+            e.priority = quint8(o.value("PRIORITY").toString("6").toInt());
+            QString unit = o.value("_SYSTEMD_UNIT").toString();
+            if (unit.isEmpty()) unit = o.value("SYSLOG_IDENTIFIER").toString();
+            if (unit.isEmpty()) unit = o.value("_TRANSPORT").toString() == "kernel" ? "kernel" : o.value("_COMM").toString();
+            e.unit = store->unitId(unit.isEmpty() ? "(none)" : unit);
+            const QJsonValue message = o.value("MESSAGE");
+            if (message.isArray()) {
+                QByteArray bytes;
+                for (const QJsonValue &b : message.toArray()) bytes.append(char(b.toInt()));
+                e.message = QString::fromUtf8(bytes);
+            } else {
+                e.message = message.toString();
+            }
+            store->append(std::move(e));
+        }
+        if (store->endSeq() > from) emit appended(from, store->endSeq());
+    }
+
+    void pollFiles() {
+        const quint64 from = store->endSeq();
+        for (auto it = offsets.begin(); it != offsets.end(); ++it) {
+            QFile f(it.key());
+            if (!f.open(QIODevice::ReadOnly)) continue;
+            if (f.size() < it.value()) it.value() = tailOffset(it.key(), f.size()); // rotated
+            if (f.size() == it.value()) continue;
+            f.seek(it.value());
+            const quint16 unit = store->unitId(QFileInfo(it.key()).fileName());
+            while (!f.atEnd()) {
+                const QByteArray line = f.readLine();
+                if (!line.endsWith('\n')) break;
+                it.value() = f.pos();
+                if (resync.remove(it.key())) continue; // the tail started mid-line
+                store->append(parseLine(QString::fromUtf8(line).trimmed(), unit));
+            }
+        }
+        if (store->endSeq() > from) emit appended(from, store->endSeq());
+    }
+
+private:
+    // Starts a file at its last 256 KB; a seek past the start lands
+    // mid-line, so the first partial line is dropped once.
+    qint64 tailOffset(const QString &path, qint64 size) {
+        const qint64 offset = qMax<qint64>(0, size - 256 * 1024);
+        if (offset > 0) resync.insert(path);
+        else resync.remove(path);
+        return offset;
+    }
+
+    // Plain log files carry no priority, so it is guessed from the text.
+    static LogStore::Entry parseLine(const QString &line, quint16 unit) {
+        LogStore::Entry e;
+        e.unit = unit;
+        e.message = line;
+        const QString head = line.section(' ', 0, 0);
+        QDateTime time = QDateTime::fromString(head, Qt::ISODateWithMs);
+        if (!time.isValid()) {
+            time = QDateTime::fromString(line.left(15).simplified(), "MMM d HH:mm:ss");
+            if (time.isValid()) time = time.addYears(QDate::currentDate().year() - time.date().year());
+        }
+        e.timeUs = (time.isValid() ? time : QDateTime::currentDateTime()).toMSecsSinceEpoch() * 1000;
+        const QString lower = line.toLower();
+        if (lower.contains("error") || lower.contains("fail") || lower.contains("(ee)")) e.priority = 3;
+        else if (lower.contains("warn") || lower.contains("(ww)")) e.priority = 4;
+        return e;
+    }
+
+    LogStore *store;
+    QProcess *journal = nullptr;
+    QTimer filePoll;
+    QMap<QString, qint64> offsets;
+    QSet<QString> resync;
+};
+
+class LogModel : public QAbstractTableModel {
+    Q_OBJECT
+public:
+    enum Column { Time, Priority, Unit, Message, ColumnCount };
+
+    explicit LogModel(const LogStore *store, QObject *parent = nullptr) : QAbstractTableModel(parent), store(store) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : int(rows.size());
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override {
+        return parent.isValid() ? 0 : ColumnCount;
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override {
+        static const char *titles[] = {"Time", "Priority", "Unit", "Message"};
+        if (orientation == Qt::Horizontal && role == Qt::DisplayRole) return titles[section];
+        return QVariant();
+    }
+
+    static QString priorityName(int p) {
+        static const char *names[] = {"emerg", "alert", "crit", "err", "warning", "notice", "info", "debug"};
+        return names[qBound(0, p, 7)];
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override {
+        if (!index.isValid()) return QVariant();
+        const LogStore::Entry &e = store->at(rows[index.row()]);
+        if (role == Qt::ForegroundRole) {
+            if (e.priority <= 3) return QColor("#ff5555");
+            if (e.priority == 4) return QColor("#ffb86c");
+            return QVariant();
+        }
+        if (role != Qt::DisplayRole) return QVariant();
+        switch (index.column()) {
+        case Time: return QDateTime::fromMSecsSinceEpoch(e.timeUs / 1000).toString("MMM dd HH:mm:ss");
+        case Priority: return priorityName(e.priority);
+        case Unit: return store->units().value(e.unit);
+        case Message: return e.message;
+        }
+        return QVariant();
+    }
+
+    void setFilter(const LogStore::Filter &f) {
+        beginResetModel();
+        filter = f;
+        rows = store->query(f);
+        endResetModel();
+    }
+
+    // New entries are appended without re-running the query; rows whose
+    // entries were overwritten in the ring are dropped from the top.
+    void appended(quint64 from, quint64 to) {
+        const quint64 first = store->firstSeq();
+        const auto stale = std::lower_bound(rows.begin(), rows.end(), first) - rows.begin();
+        if (stale > 0) {
+            beginRemoveRows(QModelIndex(), 0, int(stale) - 1);
+            rows.erase(rows.begin(), rows.begin() + stale);
+            endRemoveRows();
+        }
+        std::vector<quint64> added;
+        for (quint64 seq = qMax(from, first); seq < to; ++seq)
+            if (store->matches(seq, filter)) added.push_back(seq);
+        if (added.empty()) return;
+        beginInsertRows(QModelIndex(), int(rows.size()), int(rows.size() + added.size()) - 1);
+        rows.insert(rows.end(), added.begin(), added.end());
+        endInsertRows();
+    }
+
+private:
+    const LogStore *store;
+    LogStore::Filter filter;
+    std::vector<quint64> rows;
+};
+
+class LogPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit LogPanel(QWidget *parent = nullptr) : QWidget(parent), collector(&store) {
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Logs");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
 
-        auto optimGroup = new QGroupBox("Individual Optimizations");
-        auto optimLayout = new QVBoxLayout(optimGroup);
+        auto controls = new QHBoxLayout;
+        priorityCombo = new QComboBox;
+        for (int p = 0; p <= 7; ++p) priorityCombo->addItem("≤ " + LogModel::priorityName(p), p);
+        priorityCombo->setCurrentIndex(7);
+        unitCombo = new QComboBox;
+        unitCombo->addItem("All units", -1);
+        sinceCombo = new QComboBox;
+        sinceCombo->addItem("Any time", 0);
+        sinceCombo->addItem("Last 15 minutes", 15 * 60);
+        sinceCombo->addItem("Last hour", 3600);
+        sinceCombo->addItem("Last 24 hours", 86400);
+        searchEdit = new QLineEdit;
+        searchEdit->setPlaceholderText("Search messages");
+        controls->addWidget(priorityCombo);
+        controls->addWidget(unitCombo);
+        controls->addWidget(sinceCombo);
+        controls->addWidget(searchEdit, 1);
+        layout->addLayout(controls);
+
+        model = new LogModel(&store, this);
+        table = new QTableView;
+        table->setModel(model);
+        table->setWordWrap(false);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->verticalHeader()->hide();
+        table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 4);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->setColumnWidth(LogModel::Time, 130);
+        table->setColumnWidth(LogModel::Priority, 70);
+        table->setColumnWidth(LogModel::Unit, 180);
+        layout->addWidget(table, 1);
+
+        statusLabel = new QLabel;
+        statusLabel->setProperty("class", "smallText");
+        layout->addWidget(statusLabel);
 
-        auto esyncBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Enable ESYNC (Event Synchronization)");
-        auto fsyncBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Enable FSYNC (Fast Synchronization)");
-        auto dxvkBtn = new QPushButton(QIcon::fromTheme("applications-graphics"), "Install DXVK (DirectX to Vulkan)");
-        auto vkd3dBtn = new QPushButton(QIcon::fromTheme("applications-graphics"), "Install VKD3D (DirectX 12 to Vulkan)");
-        auto largeAddrBtn = new QPushButton(QIcon::fromTheme("edit-find"), "Enable Large Address Aware");
+        searchDelay.setSingleShot(true);
+        searchDelay.setInterval(200);
+        connect(&searchDelay, &QTimer::timeout, this, &LogPanel::applyFilter);
+        connect(searchEdit, &QLineEdit::textChanged, &searchDelay, qOverload<>(&QTimer::start));
+        connect(priorityCombo, &QComboBox::currentIndexChanged, this, &LogPanel::applyFilter);
+        connect(unitCombo, &QComboBox::currentIndexChanged, this, &LogPanel::applyFilter);
+        connect(sinceCombo, &QComboBox::currentIndexChanged, this, &LogPanel::applyFilter);
+        connect(&collector, &LogCollector::appended, this, &LogPanel::appended);
+    }
 
-        connect(esyncBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableEsync);
-        connect(fsyncBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableFsync);
-        connect(dxvkBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installDXVK);
-        connect(vkd3dBtn, &QPushButton::clicked, this, &WineOptimizerDialog::installVKD3D);
-        connect(largeAddrBtn, &QPushButton::clicked, this, &WineOptimizerDialog::enableLargeAddr);
+protected:
+    void showEvent(QShowEvent *event) override {
+        if (!started) {
+            started = true;
+            collector.start();
+        }
+        QWidget::showEvent(event);
+    }
 
-        optimLayout->addWidget(esyncBtn);
-        optimLayout->addWidget(fsyncBtn);
-        optimLayout->addWidget(dxvkBtn);
-        optimLayout->addWidget(vkd3dBtn);
-        optimLayout->addWidget(largeAddrBtn);
+private slots:
+    void applyFilter() {
+        LogStore::Filter f;
+        f.maxPriority = priorityCombo->currentData().toInt();
+        f.unit = unitCombo->currentData().toInt();
+        const qint64 since = sinceCombo->currentData().toLongLong();
+        if (since > 0) f.sinceUs = (QDateTime::currentSecsSinceEpoch() - since) * 1000000;
+        f.text = searchEdit->text().trimmed();
+        QElapsedTimer timer;
+        timer.start();
+        model->setFilter(f);
+        lastQueryMs = timer.elapsed();
+        table->scrollToBottom();
+        updateStatus();
+    }
 
-        layout->addWidget(presetsGroup);
-        layout->addWidget(optimGroup);
-        layout->addStretch();
+    void appended(quint64 from, quint64 to) {
+        QScrollBar *bar = table->verticalScrollBar();
+        const bool follow = bar->value() == bar->maximum();
+        model->appended(from, to);
+        if (follow) table->scrollToBottom();
 
-        return widget;
+        const QSignalBlocker blocker(unitCombo);
+        for (int id = unitCombo->count() - 1; id < store.units().size(); ++id)
+            unitCombo->addItem(store.units().at(id), id);
+        updateStatus();
     }
 
-    QWidget* createConfigTab() {
-        auto widget = new QWidget;
-        auto layout = new QVBoxLayout(widget);
+private:
+    void updateStatus() {
+        statusLabel->setText(QString("%1 of %2 buffered lines shown, filtered in %3 ms")
+                                 .arg(model->rowCount()).arg(store.endSeq() - store.firstSeq()).arg(lastQueryMs));
+    }
 
-        auto infoLabel = new QLabel("Configure Wine prefixes and Windows version emulation.");
-        layout->addWidget(infoLabel);
+    LogStore store;
+    LogCollector collector;
+    LogModel *model;
+    QTableView *table;
+    QComboBox *priorityCombo;
+    QComboBox *unitCombo;
+    QComboBox *sinceCombo;
+    QLineEdit *searchEdit;
+    QLabel *statusLabel;
+    QTimer searchDelay;
+    qint64 lastQueryMs = 0;
+    bool started = false;
+};
 
-        auto prefixGroup = new QGroupBox("Wine Prefix");
-        auto prefixLayout = new QVBoxLayout(prefixGroup);
+class BenchmarkPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit BenchmarkPanel(QWidget *parent = nullptr) : QWidget(parent) {
+        auto layout = new QVBoxLayout(this);
 
-        auto prefixLabel = new QLabel("Select or create a Wine prefix:");
-        prefixLayout->addWidget(prefixLabel);
+        auto titleLabel = new QLabel("Benchmark");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
 
-        winePrefixCombo = new QComboBox;
-        winePrefixCombo->addItem("Default (~/.wine)");
-        winePrefixCombo->setEditable(false);
-        prefixLayout->addWidget(winePrefixCombo);
+        auto hint = new QLabel("A fixed workload covering CPU, memory and disk that takes under a minute. "
+                               "Close busy programs first so runs stay comparable.");
+        hint->setWordWrap(true);
+        hint->setProperty("class", "smallText");
+        layout->addWidget(hint);
 
-        customPrefixEdit = new QLineEdit;
-        customPrefixEdit->setPlaceholderText("Or enter custom prefix path...");
-        prefixLayout->addWidget(customPrefixEdit);
+        resultTree = new QTreeWidget;
+        resultTree->setHeaderLabels({"Test", "Latest", "Previous", "Change"});
+        resultTree->setRootIsDecorated(false);
+        resultTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(resultTree, 1);
 
-        auto createPrefixBtn = new QPushButton(QIcon::fromTheme("list-add"), "Create New Prefix");
-        connect(createPrefixBtn, &QPushButton::clicked, this, &WineOptimizerDialog::createPrefix);
-        prefixLayout->addWidget(createPrefixBtn);
+        statusLabel = new QLabel;
+        statusLabel->setProperty("class", "smallText");
+        layout->addWidget(statusLabel);
 
-        auto winverGroup = new QGroupBox("Windows Version");
-        auto winverLayout = new QVBoxLayout(winverGroup);
+        progress = new QProgressBar;
+        progress->setRange(0, int(Benchmark::tests().size()));
+        progress->hide();
+        layout->addWidget(progress);
+
+        runBtn = new QPushButton(QIcon::fromTheme("media-playback-start"), "Run Benchmark");
+        runBtn->setProperty("class", "plainButton");
+        layout->addWidget(runBtn);
+        connect(runBtn, &QPushButton::clicked, this, [this]() {
+            if (watcher) watcher->cancel();
+            else start();
+        });
 
-        auto winverCombo = new QComboBox;
-        winverCombo->addItems({"Windows 10", "Windows 8.1", "Windows 7", "Windows XP"});
-        winverLayout->addWidget(winverCombo);
+        showHistory();
+    }
 
-        auto setWinverBtn = new QPushButton(QIcon::fromTheme("preferences-desktop"), "Set Windows Version");
-        connect(setWinverBtn, &QPushButton::clicked, [this, winverCombo]() {
-            setWindowsVersion(winverCombo->currentText());
+private:
+    void start() {
+        runBtn->setText("Cancel");
+        progress->setValue(0);
+        progress->show();
+        watcher = new QFutureWatcher<Benchmark::Run>(this);
+        connect(watcher, &QFutureWatcher<Benchmark::Run>::progressValueChanged, progress, &QProgressBar::setValue);
+        connect(watcher, &QFutureWatcher<Benchmark::Run>::progressTextChanged, statusLabel, &QLabel::setText);
+        connect(watcher, &QFutureWatcher<Benchmark::Run>::finished, this, [this]() {
+            if (!watcher->isCanceled() && watcher->future().resultCount() > 0) {
+                const Benchmark::Run run = watcher->result();
+                InventorySnapshot::update([&run](InventorySnapshot &snapshot) { snapshot.addBenchmark(run); });
+            }
+            watcher->deleteLater();
+            watcher = nullptr;
+            progress->hide();
+            runBtn->setText("Run Benchmark");
+            showHistory();
         });
-        winverLayout->addWidget(setWinverBtn);
+        watcher->setFuture(QtConcurrent::run([](QPromise<Benchmark::Run> &promise) {
+            promise.setProgressRange(0, int(Benchmark::tests().size()));
+            const auto run = Benchmark::run([&promise](int step) {
+                promise.setProgressValueAndText(step, QString("Running: %1...").arg(Benchmark::tests()[step].name));
+                return !promise.isCanceled();
+            });
+            if (run) promise.addResult(*run);
+        }));
+    }
 
-        auto toolsGroup = new QGroupBox("Tools");
-        auto toolsLayout = new QVBoxLayout(toolsGroup);
+    static QString format(double value) {
+        return QString::number(value, 'f', value < 10 ? 2 : value < 1000 ? 1 : 0);
+    }
 
-        auto winecfgBtn = new QPushButton(QIcon::fromTheme("preferences-system"), "Open Wine Configuration (winecfg)");
-        auto regeditBtn = new QPushButton(QIcon::fromTheme("edit-find-replace"), "Open Wine Registry Editor");
-        auto taskmgrBtn = new QPushButton(QIcon::fromTheme("utilities-system-monitor"), "Open Wine Task Manager");
+    void showHistory() {
+        resultTree->clear();
+        const auto snapshot = InventorySnapshot::load();
+        const QList<Benchmark::Run> runs = snapshot ? snapshot->benchmarks : QList<Benchmark::Run>();
+        if (runs.isEmpty()) {
+            statusLabel->setText("No benchmark has been run on this machine yet.");
+            return;
+        }
+        const Benchmark::Run &latest = runs.last();
+        const Benchmark::Run *previous = runs.size() > 1 ? &runs[runs.size() - 2] : nullptr;
+        for (const Benchmark::Test &test : Benchmark::tests()) {
+            auto item = new QTreeWidgetItem(resultTree);
+            item->setText(0, test.name);
+            if (!latest.scores.contains(test.id)) {
+                item->setText(1, "n/a");
+                continue;
+            }
+            const double now = latest.scores.value(test.id);
+            item->setText(1, format(now) + " " + test.unit);
+            if (!previous || !previous->scores.contains(test.id)) continue;
+            const double before = previous->scores.value(test.id);
+            item->setText(2, format(before) + " " + test.unit);
+            if (before <= 0) continue;
+            // Positive always means faster, whichever way the unit points.
+            const double change = (test.lowerIsBetter ? before / now - 1 : now / before - 1) * 100;
+            item->setText(3, QString("%1%2%").arg(change >= 0 ? "+" : "").arg(change, 0, 'f', 1));
+        }
+        statusLabel->setText(QString("Last run %1 on %2 (%3 threads), %4 run(s) stored.")
+                                 .arg(QDateTime::fromMSecsSinceEpoch(latest.timeMs).toString("yyyy-MM-dd HH:mm"),
+                                      latest.cpuModel).arg(latest.threads).arg(runs.size()));
+    }
 
-        connect(winecfgBtn, &QPushButton::clicked, []() { QProcess::startDetached("winecfg"); });
-        connect(regeditBtn, &QPushButton::clicked, []() { QProcess::startDetached("wine", {"regedit"}); });
-        connect(taskmgrBtn, &QPushButton::clicked, []() { QProcess::startDetached("wine", {"taskmgr"}); });
+    QTreeWidget *resultTree;
+    QLabel *statusLabel;
+    QProgressBar *progress;
+    QPushButton *runBtn;
+    QFutureWatcher<Benchmark::Run> *watcher = nullptr;
+};
 
-        toolsLayout->addWidget(winecfgBtn);
-        toolsLayout->addWidget(regeditBtn);
-        toolsLayout->addWidget(taskmgrBtn);
+class SystemCleanup {
+public:
+    enum Category { AptArchives, Autoremove, OldKernels, FlatpakUnused, UserCache, CategoryCount };
 
-        layout->addWidget(prefixGroup);
-        layout->addWidget(winverGroup);
-        layout->addWidget(toolsGroup);
-        layout->addStretch();
+    struct Result {
+        Category category = AptArchives;
+        qint64 bytes = 0;
+        QStringList items;
+        QString path;
+    };
 
-        return widget;
+    static QString categoryName(Category c) {
+        switch (c) {
+        case AptArchives: return "Downloaded package archives";
+        case Autoremove: return "Packages no longer needed";
+        case OldKernels: return "Old kernels";
+        case FlatpakUnused: return "Unused Flatpak runtimes";
+        case UserCache: return "Application cache (~/.cache)";
+        default: return "Other";
+        }
     }
 
-    QWidget* createCleanupTab() {
-        auto widget = new QWidget;
-        auto layout = new QVBoxLayout(widget);
+    static Result measure(Category c) {
+        switch (c) {
+        case AptArchives: return aptArchives();
+        case Autoremove: return autoremove();
+        case OldKernels: return oldKernels();
+        case FlatpakUnused: return flatpakUnused();
+        case UserCache: return userCache();
+        default: return {c};
+        }
+    }
 
-        auto infoLabel = new QLabel(
-            "Clean up Wine prefixes, cache, and temporary files to free disk space."
-            );
-        infoLabel->setWordWrap(true);
-        layout->addWidget(infoLabel);
+    // One script for every selected category, so the whole cleanup costs a
+    // single authentication.
+    static QString script(const QList<Result> &selected) {
+        QString s = "set -u\n";
+        for (const Result &r : selected) {
+            switch (r.category) {
+            case AptArchives:
+                s += "echo 'Cleaning package archives...'\napt-get clean\n";
+                break;
+            case Autoremove:
+                s += "echo 'Removing unneeded packages...'\napt-get -y autoremove --purge\n";
+                break;
+            case OldKernels:
+                if (!r.items.isEmpty()) s += "echo 'Purging old kernels...'\napt-get -y purge " + r.items.join(' ') + "\n";
+                break;
+            case FlatpakUnused:
+                s += "echo 'Removing unused Flatpak runtimes...'\n"
+                     "flatpak uninstall --system --unused -y --noninteractive\n"
+                     "[ -n \"${SUDO_USER:-}\" ] && sudo -u \"$SUDO_USER\" flatpak uninstall --user --unused -y --noninteractive\n";
+                break;
+            case UserCache: {
+                // The directory that was measured, which honours XDG_CACHE_HOME;
+                // our own cache holds the inventory snapshot.
+                if (r.path.isEmpty()) break;
+                const QString dir = "'" + QString(r.path).replace("'", "'\\''") + "'";
+                s += "echo 'Clearing the application cache...'\n";
+                s += QString("[ -d %1 ] && sudo -u \"${SUDO_USER:-root}\" find %1 -mindepth 1 -maxdepth 1 ! -name err_ -exec rm -rf {} +\n").arg(dir);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        s += "echo Done.\n";
+        return s;
+    }
 
-        auto cacheBtn = new QPushButton(QIcon::fromTheme("edit-clear"), "Clear Wine Cache");
-        auto tempBtn = new QPushButton(QIcon::fromTheme("edit-clear"), "Clean Temp Files");
-        auto prefixBtn = new QPushButton(QIcon::fromTheme("user-trash"), "Remove Unused Prefixes");
-        auto fullCleanBtn = new QPushButton(QIcon::fromTheme("edit-clear-all"), "Full Cleanup (All Above)");
+private:
+    static QString run(const QString &program, const QStringList &args) {
+        QProcess p;
+        p.start(program, args);
+        if (!p.waitForFinished(30000)) return QString();
+        return QString::fromUtf8(p.readAllStandardOutput());
+    }
 
-        connect(cacheBtn, &QPushButton::clicked, this, &WineOptimizerDialog::clearCache);
-        connect(tempBtn, &QPushButton::clicked, this, &WineOptimizerDialog::clearTemp);
-        connect(prefixBtn, &QPushButton::clicked, this, &WineOptimizerDialog::cleanPrefixes);
-        connect(fullCleanBtn, &QPushButton::clicked, this, &WineOptimizerDialog::fullCleanup);
+    static qint64 installedSize(const QStringList &packages) {
+        if (packages.isEmpty()) return 0;
+        qint64 kib = 0;
+        const QStringList sizes = run("dpkg-query", QStringList{"-W", "-f=${Installed-Size}\\n"} + packages).split('\n', Qt::SkipEmptyParts);
+        for (const QString &size : sizes) kib += size.toLongLong();
+        return kib * 1024;
+    }
 
-        layout->addWidget(cacheBtn);
-        layout->addWidget(tempBtn);
-        layout->addWidget(prefixBtn);
-        layout->addWidget(fullCleanBtn);
-        layout->addStretch();
+    static Result aptArchives() {
+        Result r{AptArchives};
+        QDirIterator it("/var/cache/apt/archives", {"*.deb"}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            r.bytes += it.fileInfo().size();
+            r.items << it.fileName();
+        }
+        for (const char *bin : {"/var/cache/apt/pkgcache.bin", "/var/cache/apt/srcpkgcache.bin"})
+            r.bytes += QFileInfo(bin).size();
+        return r;
+    }
 
-        return widget;
+    static QStringList autoremovable() {
+        QStringList packages;
+        const QStringList lines = run("apt-get", {"-s", "autoremove"}).split('\n');
+        for (const QString &line : lines)
+            if (line.startsWith("Remv ")) packages << line.section(' ', 1, 1);
+        return packages;
     }
 
-private slots:
-    void checkWineInstallation() {
-        QString version = execProcess("wine", {"--version"});
-        if (version.isEmpty()) {
-            statusLabel->setText("Wine not installed");
-            wineVersionLabel->setText("Wine Version: Not Installed");
-            logArea->append("Wine is not installed on this system.");
-        } else {
-            statusLabel->setText(QString("Wine installed: %1").arg(version));
-            wineVersionLabel->setText(QString("Wine Version: %1").arg(version));
-            logArea->append(QString("Wine detected: %1").arg(version));
+    static Result autoremove() {
+        Result r{Autoremove};
+        r.items = autoremovable();
+        r.bytes = installedSize(r.items);
+        return r;
+    }
+
+    // Keeps the running kernel and the newest installed one; meta packages
+    // such as linux-image-amd64 never match the versioned pattern. Kernels
+    // apt would autoremove are already counted there.
+    static Result oldKernels() {
+        Result r{OldKernels};
+        static const QRegularExpression versioned("^linux-(?:image|modules|modules-extra|headers)-(\\d+(?:\\.\\d+)*(?:-\\d+)?)\\S*$");
+        static const QRegularExpression digits("\\D+");
+        const QString running = versioned.match("linux-image-" + QSysInfo::kernelVersion()).captured(1);
+        QMap<QString, QStringList> byVersion;
+        const QStringList lines = run("dpkg-query", {"-W", "-f=${Package} ${db:Status-Abbrev}\\n", "linux-*"}).split('\n', Qt::SkipEmptyParts);
+        for (const QString &line : lines) {
+            if (!line.section(' ', 1).startsWith("ii")) continue;
+            const auto m = versioned.match(line.section(' ', 0, 0));
+            if (!m.hasMatch()) continue;
+            byVersion[m.captured(1)] << m.captured(0);
+        }
+        QStringList versions = byVersion.keys();
+        auto key = [](const QString &v) {
+            QList<int> parts;
+            for (const QString &n : v.split(digits, Qt::SkipEmptyParts)) parts << n.toInt();
+            return parts;
+        };
+        std::sort(versions.begin(), versions.end(), [&key](const QString &a, const QString &b) { return key(a) < key(b); });
+        if (!versions.isEmpty()) versions.removeLast();
+        const QStringList superseded = autoremovable();
+        for (const QString &version : std::as_const(versions)) {
+            if (version == running) continue;
+            for (const QString &package : byVersion.value(version))
+                if (!superseded.contains(package)) r.items << package;
         }
+        r.bytes = installedSize(r.items);
+        return r;
     }
 
-    void installWineStable() {
-        logArea->append("\nInstalling Wine Stable...");
-        QString cmd = "dpkg --add-architecture i386 && apt update && "
-                      "apt install -y wine wine32 wine64 libwine libwine:i386 fonts-wine";
-        runInTerminal(cmd, this, "Installing Wine Stable");
-        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    static qint64 parseSize(const QString &text) {
+        static const QRegularExpression re("([\\d.,]+)\\s*([kMGT]?)B");
+        const auto m = re.match(text);
+        if (!m.hasMatch()) return 0;
+        const QString unit = m.captured(2);
+        const double scale = unit == "k" ? 1e3 : unit == "M" ? 1e6 : unit == "G" ? 1e9 : unit == "T" ? 1e12 : 1;
+        return qint64(QString(m.captured(1)).replace(',', '.').toDouble() * scale);
     }
 
-    void installWineStaging() {
-        logArea->append("\nInstalling Wine Staging...");
-        QString cmd = "dpkg --add-architecture i386 && "
-                      "wget -nc https://dl.winehq.org/wine-builds/winehq.key && "
-                      "apt-key add winehq.key && "
-                      "add-apt-repository 'deb https://dl.winehq.org/wine-builds/debian/ bookworm main' && "
-                      "apt update && apt install -y --install-recommends winehq-staging";
-        runInTerminal(cmd, this, "Installing Wine Staging");
-        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    // Flatpak has no dry run for --unused, so this approximates it: runtimes
+    // no installed app uses, other than extensions of the ones in use.
+    static Result flatpakUnused() {
+        Result r{FlatpakUnused};
+        if (QStandardPaths::findExecutable("flatpak").isEmpty()) return r;
+        // Each app and base runtime owns the refs under its ID (.Locale,
+        // .Debug, .GL...), and GNOME and KDE bases load the freedesktop GL
+        // and codec extensions, so all of those count as in use.
+        QSet<QString> used;
+        const QStringList apps = run("flatpak", {"list", "--app", "--columns=application,runtime"}).split('\n', Qt::SkipEmptyParts);
+        for (const QString &line : apps) {
+            used.insert(line.section('\t', 0, 0).trimmed());
+            used.insert(line.section('\t', 1, 1).section('/', 0, 0).trimmed());
+        }
+        used.remove(QString());
+        if (!used.isEmpty()) {
+            for (const char *shared : {"org.freedesktop.Platform.GL", "org.freedesktop.Platform.GL32", "org.freedesktop.Platform.VAAPI",
+                                       "org.freedesktop.Platform.openh264", "org.freedesktop.Platform.ffmpeg-full", "org.freedesktop.Platform.codecs"})
+                used.insert(shared);
+        }
+        const QStringList runtimes = run("flatpak", {"list", "--runtime", "--columns=application,size"}).split('\n', Qt::SkipEmptyParts);
+        for (const QString &line : runtimes) {
+            const QString id = line.section('\t', 0, 0).trimmed();
+            const bool inUse = std::any_of(used.begin(), used.end(), [&id](const QString &u) {
+                return id == u || id.startsWith(u + ".");
+            });
+            if (inUse) continue;
+            r.items << id;
+            r.bytes += parseSize(line.section('\t', 1));
+        }
+        return r;
     }
 
-    void updateWine() {
-        logArea->append("\nUpdating Wine...");
-        runInTerminal("apt update && apt upgrade -y wine* winehq*", this, "Updating Wine");
-        QTimer::singleShot(3000, this, &WineOptimizerDialog::checkWineInstallation);
+    static Result userCache() {
+        Result r{UserCache};
+        const QString cache = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        r.path = cache;
+        const QStringList entries = QDir(cache).entryList(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot);
+        for (const QString &entry : entries) {
+            if (entry == "err_") continue;
+            r.items << entry;
+            const QFileInfo fi(cache + "/" + entry);
+            if (!fi.isDir() || fi.isSymLink()) {
+                r.bytes += fi.size();
+                continue;
+            }
+            QDirIterator it(fi.filePath(), QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                it.next();
+                r.bytes += it.fileInfo().size();
+            }
+        }
+        return r;
     }
+};
 
-    void applyGamingPreset() {
-        logArea->append("\nApplying Gaming Preset...");
-        logArea->append("  • Enabling ESYNC");
-        logArea->append("  • Enabling FSYNC");
-        logArea->append("  • Installing DXVK");
-        logArea->append("  • Optimizing registry settings");
+class SystemCleanupDialog : public QDialog {
+    Q_OBJECT
+public:
+    explicit SystemCleanupDialog(QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowTitle("System Cleanup");
+        resize(560, 380);
+        auto layout = new QVBoxLayout(this);
 
-        enableEsync();
-        enableFsync();
-        QProcess::execute("wine", {"reg", "add", "HKCU\\Software\\Wine\\Direct3D", "/v", "csmt", "/t", "REG_DWORD", "/d", "1", "/f"});
-        QProcess::execute("wine", {"reg", "add", "HKCU\\Software\\Wine\\Direct3D", "/v", "MaxVersionGL", "/t", "REG_DWORD", "/d", "40600", "/f"});
-        installDXVK();
-        logArea->append("Gaming preset applied!");
+        auto titleLabel = new QLabel("System Cleanup");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
+
+        categoryList = new QListWidget;
+        layout->addWidget(categoryList, 1);
+
+        totalLabel = new QLabel("Measuring...");
+        totalLabel->setProperty("class", "smallText");
+        layout->addWidget(totalLabel);
+
+        cleanBtn = new QPushButton(QIcon::fromTheme("edit-clear-all"), "Clean Selected");
+        cleanBtn->setProperty("class", "plainButton");
+        cleanBtn->setEnabled(false);
+        layout->addWidget(cleanBtn);
+
+        connect(cleanBtn, &QPushButton::clicked, this, &SystemCleanupDialog::cleanSelected);
+        connect(categoryList, &QListWidget::itemChanged, this, &SystemCleanupDialog::updateTotal);
+
+        for (int c = 0; c < SystemCleanup::CategoryCount; ++c) {
+            auto item = new QListWidgetItem(SystemCleanup::categoryName(SystemCleanup::Category(c)) + " - measuring...");
+            item->setFlags(item->flags() & ~Qt::ItemIsUserCheckable);
+            categoryList->addItem(item);
+            results.append({SystemCleanup::Category(c)});
+
+            // Each category is measured on its own so the quick ones show up
+            // while apt and flatpak are still being queried.
+            auto watcher = new QFutureWatcher<SystemCleanup::Result>(this);
+            connect(watcher, &QFutureWatcher<SystemCleanup::Result>::finished, this, [this, watcher, item, c]() {
+                const SystemCleanup::Result r = watcher->result();
+                watcher->deleteLater();
+                results[c] = r;
+                const QSignalBlocker blocker(categoryList);
+                QString text = SystemCleanup::categoryName(r.category) + " - " + formatBytes(r.bytes);
+                if (!r.items.isEmpty()) text += QString(" (%1 items)").arg(r.items.size());
+                item->setText(text);
+                item->setToolTip(r.items.mid(0, 40).join('\n'));
+                item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+                item->setCheckState(r.bytes > 0 && r.category != SystemCleanup::UserCache ? Qt::Checked : Qt::Unchecked);
+                ++measured;
+                updateTotal();
+            });
+            watcher->setFuture(QtConcurrent::run(SystemCleanup::measure, SystemCleanup::Category(c)));
+        }
     }
 
-    void applyBalancedPreset() {
-        logArea->append("\nApplying Balanced Preset...");
-        enableEsync();
-        logArea->append("Balanced preset applied!");
+private slots:
+    void updateTotal() {
+        qint64 total = 0;
+        for (int i = 0; i < categoryList->count(); ++i)
+            if (categoryList->item(i)->checkState() == Qt::Checked) total += results[i].bytes;
+        QString text = "Reclaimable: " + formatBytes(total);
+        if (measured < SystemCleanup::CategoryCount) text += " (still measuring...)";
+        totalLabel->setText(text);
+        cleanBtn->setEnabled(total > 0);
     }
 
-    void applyCompatPreset() {
-        logArea->append("\nApplying Compatibility Preset...");
-        QProcess::execute("wine", {"reg", "add", "HKCU\\Software\\Wine\\Direct3D", "/v", "StrictDrawOrdering", "/t", "REG_DWORD", "/d", "1", "/f"});
-        logArea->append("Compatibility preset applied!");
+    void cleanSelected() {
+        QList<SystemCleanup::Result> selected;
+        for (int i = 0; i < categoryList->count(); ++i)
+            if (categoryList->item(i)->checkState() == Qt::Checked) selected << results[i];
+        if (selected.isEmpty()) return;
+        runScriptInTerminal(SystemCleanup::script(selected), parentWidget(), "Cleaning up the system...");
+        accept();
     }
 
-    void enableEsync() {
-        logArea->append("\nEnabling ESYNC...");
-        QFile bashrc(QDir::homePath() + "/.bashrc");
-        if (bashrc.open(QIODevice::ReadWrite | QIODevice::Text)) {
-            QTextStream in(&bashrc);
-            QString content = in.readAll();
-            if (!content.contains("WINEESYNC=1")) {
-                QTextStream out(&bashrc);
-                out << "\nexport WINEESYNC=1\n";
+private:
+    QListWidget *categoryList;
+    QLabel *totalLabel;
+    QPushButton *cleanBtn;
+    QList<SystemCleanup::Result> results;
+    int measured = 0;
+};
+
+class AptSources {
+public:
+    struct Entry {
+        QString file;
+        QString uri;
+        QString suite;
+    };
+
+    static QStringList files() {
+        QStringList out;
+        if (QFile::exists("/etc/apt/sources.list")) out << "/etc/apt/sources.list";
+        for (const QFileInfo &fi : QDir("/etc/apt/sources.list.d").entryInfoList({"*.list", "*.sources"}, QDir::Files, QDir::Name))
+            out << fi.absoluteFilePath();
+        return out;
+    }
+
+    // Reads both the one-line and the deb822 formats.
+    static QList<Entry> entries() {
+        QList<Entry> out;
+        for (const QString &path : files()) {
+            QFile f(path);
+            if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+            QStringList uris, suites;
+            auto flush = [&]() {
+                for (const QString &uri : std::as_const(uris))
+                    out << Entry{path, uri, suites.value(0)};
+                uris.clear();
+                suites.clear();
+            };
+            for (QString line : QString::fromUtf8(f.readAll()).split('\n')) {
+                line = line.section('#', 0, 0).trimmed();
+                if (path.endsWith(".sources")) {
+                    if (line.isEmpty()) flush();
+                    else if (line.startsWith("URIs:", Qt::CaseInsensitive)) uris = line.mid(5).split(' ', Qt::SkipEmptyParts);
+                    else if (line.startsWith("Suites:", Qt::CaseInsensitive)) suites = line.mid(7).split(' ', Qt::SkipEmptyParts);
+                    continue;
+                }
+                if (!line.startsWith("deb ")) continue;
+                line.remove(QRegularExpression("\\[[^\\]]*\\]"));
+                const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+                if (parts.size() >= 3) out << Entry{path, parts[1], parts[2]};
             }
-            bashrc.close();
+            flush();
         }
-        logArea->append("ESYNC enabled! Restart terminal to apply.");
+        return out;
     }
 
-    void enableFsync() {
-        logArea->append("\nEnabling FSYNC...");
-        QFile bashrc(QDir::homePath() + "/.bashrc");
-        if (bashrc.open(QIODevice::ReadWrite | QIODevice::Text)) {
-            QTextStream in(&bashrc);
-            QString content = in.readAll();
-            if (!content.contains("WINEFSYNC=1")) {
-                QTextStream out(&bashrc);
-                out << "\nexport WINEFSYNC=1\n";
-            }
-            bashrc.close();
+    // The main archive, i.e. the first http(s) mirror that is not a
+    // security or third-party repository.
+    static std::optional<Entry> primary() {
+        for (const Entry &e : entries()) {
+            const QUrl url(e.uri);
+            if (!url.scheme().startsWith("http") || e.uri.contains("security")) continue;
+            if (url.path().startsWith("/debian") || url.path().startsWith("/ubuntu")) return Entry{e.file, normalized(e.uri), e.suite};
         }
-        logArea->append("FSYNC enabled! Restart terminal to apply.");
+        return std::nullopt;
     }
 
-    void installDXVK() {
-        logArea->append("\nInstalling DXVK...");
-        runInTerminal("apt install -y dxvk", this, "Installing DXVK");
+    static QString backupDir() { return "/var/backups/err_-apt"; }
+
+    static QString normalized(QString uri) {
+        while (uri.endsWith('/')) uri.chop(1);
+        return uri;
     }
 
-    void installVKD3D() {
-        logArea->append("\nInstalling VKD3D...");
-        runInTerminal("apt install -y vkd3d-compiler libvkd3d1 libvkd3d-dev", this, "Installing VKD3D");
+    // Replaces the primary URI everywhere, then runs apt-get update and puts
+    // the previous files back if the new mirror does not work. The backup
+    // directory keeps the files from before the first switch; later
+    // switches only add files it does not hold yet.
+    static QString switchScript(const QString &from, const QString &to) {
+        QStringList touched;
+        for (const Entry &e : entries())
+            if (normalized(e.uri) == from && !touched.contains(e.file)) touched << e.file;
+        const QString list = touched.join(' ');
+        // Whole-word match, so .../debian does not also rewrite .../debian-security.
+        // Both halves are escaped for sed (the # delimiter included) and
+        // then for the single-quoted shell word around the expression.
+        auto shellSafe = [](QString text) { return text.replace("'", "'\\''"); };
+        const QString pattern = shellSafe(QString(from).replace(QRegularExpression("([.*+?^$(){}|#\\[\\]\\\\])"), "\\\\1"));
+        const QString replacement = shellSafe(QString(to).replace(QRegularExpression("([&#\\\\])"), "\\\\1"));
+        QString s = "set -u\n";
+        s += "previous=$(mktemp -d /tmp/err_-apt-XXXXXX)\n";
+        // Replaces the runner's trap, so it still removes the script itself.
+        s += "trap 'rm -rf \"$previous\"; rm -f \"$0\"' EXIT\n";
+        s += QString("mkdir -p %1\n").arg(backupDir());
+        s += QString("for f in %1; do cp -a --parents \"$f\" \"$previous\"/; cp -an --parents \"$f\" %2/; done\n").arg(list, backupDir());
+        s += QString("sed -i -E 's#(^|[[:space:]])%1/?([[:space:]]|$)#\\1%2\\2#g' %3\n").arg(pattern, replacement, list);
+        s += "if ! apt-get update; then\n"
+             "  echo 'apt-get update failed, restoring the previous sources...'\n";
+        s += "  cp -a \"$previous\"/etc/apt/. /etc/apt/\n";
+        s += "  apt-get update\nfi\n";
+        return s;
     }
 
-    void enableLargeAddr() {
-        logArea->append("\nEnabling Large Address Aware...");
-        QProcess::execute("wine", {"reg", "add", "HKLM\\System\\CurrentControlSet\\Control\\Session Manager\\Memory Management",
-                                   "/v", "LargeAddressAware", "/t", "REG_DWORD", "/d", "1", "/f"});
-        logArea->append("Large Address Aware enabled!");
+    static QString restoreScript() {
+        return QString("set -u\ncp -a %1/etc/apt/. /etc/apt/ && rm -rf %1\napt-get update\n").arg(backupDir());
     }
+};
 
-    void createPrefix() {
-        QString path = customPrefixEdit->text().trimmed();
-        if (path.isEmpty()) {
-            path = QFileDialog::getExistingDirectory(this, "Select Prefix Location", QDir::homePath());
+class MirrorProbe : public QObject {
+    Q_OBJECT
+public:
+    struct Result {
+        QString uri;
+        QString error;
+        qint64 connectMs = -1;
+        qint64 firstByteMs = -1;
+        qint64 bytes = 0;
+        double bytesPerSec = 0;
+
+        bool ok() const { return error.isEmpty() && bytesPerSec > 0; }
+        // Estimated time to fetch a 10 MB Packages file.
+        double score() const { return ok() ? firstByteMs + 10e6 / bytesPerSec * 1000 : std::numeric_limits<double>::max(); }
+    };
+
+    MirrorProbe(const QString &uri, const QString &suite, QObject *parent = nullptr) : QObject(parent), url(uri + "/dists/" + suite + "/Release") {
+        result.uri = uri;
+        connect(&socket, &QTcpSocket::hostFound, this, [this]() { lookupMs = clock.elapsed(); });
+        connect(&socket, &QTcpSocket::connected, this, &MirrorProbe::sendRequest);
+        connect(&socket, &QTcpSocket::readyRead, this, &MirrorProbe::readData);
+        connect(&socket, &QTcpSocket::disconnected, this, [this]() { finish(QString()); });
+        connect(&socket, &QTcpSocket::errorOccurred, this, [this]() {
+            if (socket.error() != QAbstractSocket::RemoteHostClosedError) finish(socket.errorString());
+        });
+        timeout.setSingleShot(true);
+        connect(&timeout, &QTimer::timeout, this, [this]() { finish(result.bytes > 0 ? QString() : "timed out"); });
+    }
+
+    void start() {
+        if (url.scheme() != "http") {
+            finish("only http mirrors can be probed");
+            return;
         }
-        if (!path.isEmpty()) {
-            logArea->append(QString("\nCreating Wine prefix at: %1").arg(path));
-            QProcess::execute("bash", {"-c", QString("WINEPREFIX='%1' wineboot").arg(path)});
-            logArea->append("Prefix created!");
+        clock.start();
+        timeout.start(8000);
+        socket.connectToHost(url.host(), quint16(url.port(80)));
+    }
+
+signals:
+    void finished(const MirrorProbe::Result &result);
+
+private slots:
+    void sendRequest() {
+        result.connectMs = clock.elapsed() - qMax<qint64>(lookupMs, 0);
+        requestSent = clock.elapsed();
+        socket.write(QString("GET %1 HTTP/1.1\r\nHost: %2\r\nUser-Agent: err_\r\nConnection: close\r\n\r\n")
+                         .arg(url.path(QUrl::FullyEncoded), url.host()).toLatin1());
+    }
+
+    void readData() {
+        const QByteArray data = socket.readAll();
+        if (result.firstByteMs < 0) {
+            result.firstByteMs = clock.elapsed() - qMax<qint64>(lookupMs, 0);
+            header += data;
+            const QByteArray status = header.left(header.indexOf("\r\n"));
+            if (!status.startsWith("HTTP/") || status.split(' ').value(1) != "200") {
+                finish(status.isEmpty() ? "bad response" : QString::fromLatin1(status.mid(9)));
+                return;
+            }
         }
+        result.bytes += data.size();
+        if (result.bytes >= 4 * 1024 * 1024) finish(QString());
     }
 
-    void setWindowsVersion(const QString &version) {
-        QString winver;
-        if (version.contains("10")) winver = "win10";
-        else if (version.contains("8")) winver = "win81";
-        else if (version.contains("7")) winver = "win7";
-        else winver = "winxp";
+private:
+    void finish(const QString &error) {
+        if (done) return;
+        done = true;
+        timeout.stop();
+        // Timed from the request, since a small Release file may arrive in
+        // the very chunk that would otherwise start the clock.
+        const qint64 elapsed = clock.isValid() && requestSent >= 0 ? qMax<qint64>(clock.elapsed() - requestSent, 1) : 0;
+        result.error = error;
+        if (error.isEmpty() && result.bytes > 0 && elapsed > 0) result.bytesPerSec = result.bytes * 1000.0 / elapsed;
+        else if (error.isEmpty()) result.error = "no data";
+        socket.abort();
+        emit finished(result);
+    }
+
+    QUrl url;
+    QTcpSocket socket;
+    QTimer timeout;
+    QElapsedTimer clock;
+    QByteArray header;
+    qint64 lookupMs = -1;
+    qint64 requestSent = -1;
+    bool done = false;
+    Result result;
+};
+
+class MirrorBenchmarkDialog : public QDialog {
+    Q_OBJECT
+public:
+    explicit MirrorBenchmarkDialog(QWidget *parent = nullptr) : QDialog(parent) {
+        setWindowTitle("Mirror Benchmark");
+        resize(720, 460);
+        auto layout = new QVBoxLayout(this);
+
+        auto titleLabel = new QLabel("Mirror Benchmark");
+        titleLabel->setProperty("class", "titleText");
+        layout->addWidget(titleLabel);
 
-        logArea->append(QString("\nSetting Windows version to: %1").arg(version));
-        QProcess::execute("wine", {"reg", "add", "HKLM\\Software\\Microsoft\\Windows NT\\CurrentVersion",
-                                   "/v", "CurrentVersion", "/t", "REG_SZ", "/d", winver, "/f"});
-        logArea->append("Windows version set!");
-    }
-
-    void clearCache() {
-        logArea->append("\nClearing Wine cache...");
-        QDir(QString("%1/.cache/wine").arg(QDir::homePath())).removeRecursively();
-        QDir(QString("%1/.cache/winetricks").arg(QDir::homePath())).removeRecursively();
-        logArea->append("Cache cleared!");
-    }
-
-    void clearTemp() {
-        logArea->append("\nCleaning temp files...");
-        QString tempPath = QDir::homePath() + "/.wine/drive_c/windows/temp";
-        QDir tempDir(tempPath);
-        if (tempDir.exists()) {
-            QStringList entries = tempDir.entryList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-            for (int i = 0; i < entries.size(); ++i) {
-                QString fullPath = tempDir.filePath(entries.at(i));
-                if (QDir(fullPath).exists()) {
-                    QDir(fullPath).removeRecursively();
-                } else {
-                    QFile::remove(fullPath);
-                }
-            }
+        current = AptSources::primary();
+        auto currentLabel = new QLabel(current ? QString("Current mirror: %1 (%2)").arg(current->uri, current->suite)
+                                               : QString("No Debian or Ubuntu http mirror found in the apt sources."));
+        currentLabel->setProperty("class", "smallText");
+        layout->addWidget(currentLabel);
+
+        resultTree = new QTreeWidget;
+        resultTree->setHeaderLabels({"Mirror", "Connect", "First byte", "Throughput", "Status"});
+        resultTree->setRootIsDecorated(false);
+        resultTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+        layout->addWidget(resultTree, 1);
+
+        auto hint = new QLabel("Extra candidates can be listed in the ERR_MIRRORS environment variable or the mirrors/candidates setting.");
+        hint->setWordWrap(true);
+        hint->setProperty("class", "smallText");
+        layout->addWidget(hint);
+
+        auto buttons = new QHBoxLayout;
+        runBtn = new QPushButton(QIcon::fromTheme("view-refresh"), "Run Benchmark");
+        useBtn = new QPushButton(QIcon::fromTheme("dialog-ok-apply"), "Use Selected");
+        restoreBtn = new QPushButton(QIcon::fromTheme("edit-undo"), "Restore Previous Sources");
+        for (QPushButton *b : {runBtn, useBtn, restoreBtn}) {
+            b->setProperty("class", "plainButton");
+            buttons->addWidget(b);
         }
-        logArea->append("Temp files cleaned!");
+        layout->addLayout(buttons);
+        useBtn->setEnabled(false);
+        restoreBtn->setEnabled(QDir(AptSources::backupDir()).exists());
+        runBtn->setEnabled(current.has_value());
+
+        connect(runBtn, &QPushButton::clicked, this, &MirrorBenchmarkDialog::runBenchmark);
+        connect(useBtn, &QPushButton::clicked, this, [this]() {
+            QTreeWidgetItem *item = resultTree->currentItem();
+            if (!item || !current) return;
+            const QString uri = item->data(0, Qt::UserRole).toString();
+            if (uri == current->uri) return;
+            runScriptInTerminal(AptSources::switchScript(current->uri, uri), this, "Switching apt mirror...");
+            accept();
+        });
+        connect(restoreBtn, &QPushButton::clicked, this, [this]() {
+            runScriptInTerminal(AptSources::restoreScript(), this, "Restoring apt sources...");
+            accept();
+        });
     }
 
-    void cleanPrefixes() {
-        logArea->append("\nScanning for unused prefixes...");
-        logArea->append("Manual cleanup recommended. Check ~/.wine and custom locations.");
+private slots:
+    void runBenchmark() {
+        resultTree->clear();
+        results.clear();
+        runBtn->setEnabled(false);
+        useBtn->setEnabled(false);
+        const QStringList uris = candidates();
+        pending = uris.size();
+        for (const QString &uri : uris) {
+            auto probe = new MirrorProbe(uri, current->suite, this);
+            connect(probe, &MirrorProbe::finished, this, [this, probe](const MirrorProbe::Result &r) {
+                probe->deleteLater();
+                results << r;
+                showResults();
+                if (--pending == 0) runBtn->setEnabled(true);
+            });
+            probe->start();
+        }
     }
 
-    void fullCleanup() {
-        if (QMessageBox::question(this, "Full Cleanup",
-                                  "This will clear all Wine caches and temp files.\nContinue?") == QMessageBox::Yes) {
-            clearCache();
-            clearTemp();
-            logArea->append("\nFull cleanup completed!");
+private:
+    QStringList candidates() const {
+        const bool ubuntu = QUrl(current->uri).path().startsWith("/ubuntu");
+        QStringList out{current->uri};
+        if (ubuntu) {
+            out << "http://archive.ubuntu.com/ubuntu" << "http://us.archive.ubuntu.com/ubuntu"
+                << "http://de.archive.ubuntu.com/ubuntu" << "http://gb.archive.ubuntu.com/ubuntu"
+                << "http://mirrors.kernel.org/ubuntu";
+        } else {
+            out << "http://deb.debian.org/debian" << "http://ftp.us.debian.org/debian"
+                << "http://ftp.de.debian.org/debian" << "http://ftp.uk.debian.org/debian"
+                << "http://ftp.fr.debian.org/debian" << "http://ftp.jp.debian.org/debian"
+                << "http://mirrors.kernel.org/debian";
         }
+        out << QSettings().value("mirrors/candidates").toStringList();
+        out << qEnvironmentVariable("ERR_MIRRORS").split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        for (QString &uri : out) uri = AptSources::normalized(uri);
+        out.removeDuplicates();
+        return out;
     }
 
-private:
-    QString execProcess(const QString &program, const QStringList &args, int timeout = 5000) {
-        QProcess proc;
-        proc.start(program, args);
-        if (!proc.waitForFinished(timeout)) {
-            proc.kill();
+    void showResults() {
+        std::sort(results.begin(), results.end(), [](const MirrorProbe::Result &a, const MirrorProbe::Result &b) {
+            return a.score() < b.score();
+        });
+        resultTree->clear();
+        for (const MirrorProbe::Result &r : std::as_const(results)) {
+            auto item = new QTreeWidgetItem(resultTree);
+            item->setText(0, r.uri + (current && r.uri == current->uri ? "  (current)" : ""));
+            item->setData(0, Qt::UserRole, r.uri);
+            item->setText(1, r.connectMs >= 0 ? QString("%1 ms").arg(r.connectMs) : "-");
+            item->setText(2, r.firstByteMs >= 0 ? QString("%1 ms").arg(r.firstByteMs) : "-");
+            item->setText(3, r.ok() ? formatBytes(qulonglong(r.bytesPerSec)) + "/s" : "-");
+            item->setText(4, r.ok() ? "OK" : r.error);
+            if (!r.ok()) item->setDisabled(true);
+        }
+        if (!results.isEmpty() && results.first().ok()) {
+            resultTree->setCurrentItem(resultTree->topLevelItem(0));
+            useBtn->setEnabled(true);
         }
-        return QString::fromLocal8Bit(proc.readAllStandardOutput()).trimmed();
     }
 
-    QLabel *statusLabel;
-    QTextEdit *logArea;
-    QLabel *wineVersionLabel;
-    QComboBox *winePrefixCombo;
-    QLineEdit *customPrefixEdit;
+    std::optional<AptSources::Entry> current;
+    QTreeWidget *resultTree;
+    QPushButton *runBtn;
+    QPushButton *useBtn;
+    QPushButton *restoreBtn;
+    QList<MirrorProbe::Result> results;
+    int pending = 0;
 };
+
 class SettingsPanel : public QWidget {
     Q_OBJECT
 public:
@@ -1702,6 +7746,24 @@ public:
         });
         layout->addWidget(wineBtn);
 
+        QPushButton *cleanupBtn = new QPushButton("System Cleanup");
+        cleanupBtn->setProperty("class", "plainButton");
+        cleanupBtn->setIcon(QIcon::fromTheme("edit-clear-all"));
+        connect(cleanupBtn, &QPushButton::clicked, this, [this]() {
+            SystemCleanupDialog dialog(this);
+            dialog.exec();
+        });
+        layout->addWidget(cleanupBtn);
+
+        QPushButton *mirrorBtn = new QPushButton("Mirror Benchmark");
+        mirrorBtn->setProperty("class", "plainButton");
+        mirrorBtn->setIcon(QIcon::fromTheme("network-server"));
+        connect(mirrorBtn, &QPushButton::clicked, this, [this]() {
+            MirrorBenchmarkDialog dialog(this);
+            dialog.exec();
+        });
+        layout->addWidget(mirrorBtn);
+
         QPushButton *settingsBtn = new QPushButton("System Settings");
         settingsBtn->setProperty("class", "plainButton");
         settingsBtn->setIcon(QIcon::fromTheme("preferences-system"));
@@ -1728,6 +7790,14 @@ public:
         });
         layout->addWidget(wallpBtn);
 
+        QCheckBox *daemonCheck = new QCheckBox("Keep the system inventory cached in the background");
+        daemonCheck->setChecked(QSettings().value("inventory/daemon", false).toBool());
+        connect(daemonCheck, &QCheckBox::toggled, this, [](bool on) {
+            QSettings().setValue("inventory/daemon", on);
+            if (on) QProcess::startDetached(QCoreApplication::applicationFilePath(), {"--daemon"});
+        });
+        layout->addWidget(daemonCheck);
+
         QLabel *versionLabel = new QLabel("err_ v3.0 - error.dashboard for neospace");
         versionLabel->setAlignment(Qt::AlignCenter);
         versionLabel->setProperty("class", "smallText");
@@ -1742,6 +7812,79 @@ public:
         layout->addStretch();
     }
 };
+class SingleInstance : public QObject {
+    Q_OBJECT
+public:
+    explicit SingleInstance(QObject *parent = nullptr) : QObject(parent) {}
+
+    static QString socketPath() {
+        QString dir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+        if (dir.isEmpty()) dir = QDir::tempPath();
+        return dir + QString("/err_-%1.sock").arg(getuid());
+    }
+
+    // Runs before any QApplication exists, so it talks to the socket with
+    // plain POSIX calls and a second launch costs a connect and a write.
+    static bool forward(const QStringList &args) {
+        const QByteArray name = QFile::encodeName(socketPath());
+        sockaddr_un addr{};
+        if (name.size() >= qsizetype(sizeof(addr.sun_path))) return false;
+        addr.sun_family = AF_UNIX;
+        memcpy(addr.sun_path, name.constData(), name.size());
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return false;
+        bool ok = ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+        const QByteArray payload = args.join('\n').toUtf8();
+        for (qsizetype off = 0; ok && off < payload.size();) {
+            ssize_t n = ::send(fd, payload.constData() + off, payload.size() - off, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            ok = n > 0;
+            off += n;
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    // The lock sits next to the socket and is held for the primary's whole
+    // life, so only one process ever binds or clears the socket. A launch
+    // that loses the race keeps forwarding until the winner is listening.
+    static bool claim(const QStringList &args, QLockFile &lock) {
+        lock.setStaleLockTime(0);
+        for (int attempt = 0; attempt < 50; ++attempt) {
+            if (forward(args)) return false;
+            if (lock.tryLock(100)) return true;
+        }
+        return true;
+    }
+
+    bool listen() {
+        server = new QLocalServer(this);
+        server->setSocketOptions(QLocalServer::UserAccessOption);
+        if (!server->listen(socketPath())) {
+            // Only the lock holder gets here, so a leftover socket is stale.
+            QLocalServer::removeServer(socketPath());
+            if (!server->listen(socketPath())) return false;
+        }
+        connect(server, &QLocalServer::newConnection, this, [this]() {
+            while (QLocalSocket *socket = server->nextPendingConnection()) {
+                connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+                    const QStringList args = QString::fromUtf8(socket->readAll()).split('\n', Qt::SkipEmptyParts);
+                    socket->deleteLater();
+                    emit activated(args);
+                });
+            }
+        });
+        return true;
+    }
+
+signals:
+    void activated(const QStringList &args);
+
+private:
+    QLocalServer *server = nullptr;
+};
+
 class MainWindow : public QMainWindow {
     Q_OBJECT
 public:
@@ -1758,182 +7901,295 @@ public:
         layout->setContentsMargins(0, 0, 0, 0);
         layout->setSpacing(0);
 
-        QTabWidget *tabWidget = new QTabWidget(this);
+        tabWidget = new QTabWidget(this);
 
         tabWidget->addTab(new SystemInfoPanel(), QIcon::fromTheme("system-help"), "System Info");
         tabWidget->addTab(new DriverManager(), QIcon::fromTheme("driver-manager"), "Drivers");
+        tabWidget->addTab(new TuningPanel(), QIcon::fromTheme("preferences-system-performance"), "Tuning");
+        tabWidget->addTab(new MemoryPanel(), QIcon::fromTheme("media-flash"), "Memory");
+        tabWidget->addTab(new BootPanel(), QIcon::fromTheme("system-reboot"), "Boot");
+        tabWidget->addTab(new LogPanel(), QIcon::fromTheme("text-x-log"), "Logs");
+        tabWidget->addTab(new BenchmarkPanel(), QIcon::fromTheme("chronometer"), "Benchmark");
         tabWidget->addTab(new AppInstaller(), QIcon::fromTheme("system-installer"), "Install Apps");
         tabWidget->addTab(new AppRemover(), QIcon::fromTheme("edit-delete"), "Remove Apps");
+        tabWidget->addTab(new ProcessPanel(), QIcon::fromTheme("utilities-system-monitor"), "Processes");
+        tabWidget->addTab(new SensorPanel(), QIcon::fromTheme("temperature-normal"), "Sensors");
         tabWidget->addTab(new SettingsPanel(), QIcon::fromTheme("preferences-other"), "Extra Settings");
 
         layout->addWidget(tabWidget);
     }
+
+    // Arguments come from the command line or from a second launch that
+    // handed them over through SingleInstance.
+    void activate(const QStringList &args) {
+        const int tabArg = args.indexOf("--tab");
+        if (tabArg >= 0 && tabArg + 1 < args.size()) {
+            auto simplify = [](QString text) { return text.remove(QRegularExpression("[^a-z0-9]")); };
+            const QString wanted = simplify(args.at(tabArg + 1).toLower());
+            bool isIndex = false;
+            const int index = wanted.toInt(&isIndex);
+            for (int i = 0; i < tabWidget->count(); ++i) {
+                if (isIndex ? i == index : simplify(tabWidget->tabText(i).toLower()).startsWith(wanted)) {
+                    tabWidget->setCurrentIndex(i);
+                    break;
+                }
+            }
+        }
+        setWindowState((windowState() & ~Qt::WindowMinimized) | Qt::WindowActive);
+        show();
+        raise();
+        activateWindow();
+    }
+
+private:
+    QTabWidget *tabWidget;
 };
 
-#include "err_.moc"
+class InventoryDaemon : public QObject {
+    Q_OBJECT
+public:
+    explicit InventoryDaemon(QObject *parent = nullptr) : QObject(parent) {
+        snapshot = InventorySnapshot::load().value_or(InventorySnapshot());
+
+        debounce.setSingleShot(true);
+        debounce.setInterval(2000);
+        connect(&debounce, &QTimer::timeout, this, &InventoryDaemon::flush);
+
+        // dpkg replaces its status file by rename, which drops the file
+        // watch, so the directory is watched as well and the file re-added.
+        connect(&watcher, &QFileSystemWatcher::fileChanged, this, &InventoryDaemon::schedule);
+        connect(&watcher, &QFileSystemWatcher::directoryChanged, this, &InventoryDaemon::schedule);
+        watchSources();
+
+        periodic.setInterval(10 * 60 * 1000);
+        connect(&periodic, &QTimer::timeout, this, [this]() {
+            systemDirty = true;
+            flush();
+        });
+        periodic.start();
 
-int main(int argc, char *argv[])
-{
-    QApplication app(argc, argv);
-    app.setApplicationName("err_");
-    app.setApplicationVersion("3.0");
-    app.setOrganizationName("error.os");
+        systemDirty = true;
+        flush();
+    }
 
-    QFont mono("Nimbus Mono");
-    if (!mono.exactMatch()) mono = QFont("monospace");
-    mono.setStyleHint(QFont::Monospace);
-    app.setFont(mono);
+private slots:
+    void schedule(const QString &path) {
+        if (path == "/etc/os-release") systemDirty = true;
+        debounce.start();
+    }
 
-    app.setStyleSheet(R"(
-* {
-    font-family: 'Nimbus Mono', 'Monospace';
-    color: #dfe2ec;
-}
+    void flush() {
+        watchSources();
+        bool changed = false;
+        if (snapshot.packagesStale()) {
+            snapshot.refreshPackages();
+            changed = true;
+        }
+        if (systemDirty) {
+            snapshot.refreshSystem();
+            systemDirty = false;
+            changed = true;
+        }
+        if (!changed) return;
+        // Benchmark runs are appended by other processes; keep theirs.
+        InventorySnapshot::update([this](InventorySnapshot &onDisk) {
+            snapshot.benchmarks = onDisk.benchmarks;
+            onDisk = snapshot;
+        });
+    }
 
-QDialog {
-    border: 1px solid #1a3cff;
-    border-radius: 8px;
-}
+private:
+    void watchSources() {
+        const QStringList sources = {InventorySnapshot::dpkgStatusPath(), "/var/lib/dpkg", "/etc/os-release"};
+        for (const QString &path : sources) {
+            if (!watcher.files().contains(path) && !watcher.directories().contains(path) && QFileInfo::exists(path))
+                watcher.addPath(path);
+        }
+    }
 
-QMessageBox QPushButton {
-    background-color: #112266;
-    color: white;
-    border: none;
-    padding: 8px 16px;
-    border-radius: 5px;
-    font-weight: bold;
-    font-size: 12px;
-    min-width: 80px;
-}
-QMessageBox QPushButton:hover {
-    background-color: #1a3cff;
-}
+    InventorySnapshot snapshot;
+    MetricsSampler sampler;
+    QFileSystemWatcher watcher;
+    QTimer debounce;
+    QTimer periodic;
+    bool systemDirty = false;
+};
 
-QLabel[class="titleText"], QPushButton[class="titleText"] {
-    font-size: 32px;
-    font-weight: bold;
-    color: #dfe2ec;
-    border: none;
+namespace Headless {
+QJsonObject benchmarkJson(const Benchmark::Run &run) {
+    QJsonObject scores;
+    for (auto it = run.scores.begin(); it != run.scores.end(); ++it) scores.insert(it.key(), it.value());
+    return QJsonObject{
+        {"time", QDateTime::fromMSecsSinceEpoch(run.timeMs).toString(Qt::ISODate)},
+        {"cpu", run.cpuModel},
+        {"threads", run.threads},
+        {"scores", scores},
+    };
 }
 
-QLabel[class="smallText"], QPushButton[class="smallText"] {
-    font-size: 13px;
-    color: #cccccc;
-    border: none;
-}
+QJsonObject inventory() {
+    const SystemInfoFetcher::Info info = SystemInfoFetcher::fetch();
+    const QList<HardwareDetector::Gpu> gpus = HardwareDetector::gpus();
+
+    QJsonArray gpuList;
+    for (const auto &gpu : gpus) {
+        gpuList.append(QJsonObject{
+            {"slot", gpu.slot},
+            {"vendor", gpu.vendor},
+            {"vendorId", QString::asprintf("%04x", gpu.vendorId)},
+            {"deviceId", QString::asprintf("%04x", gpu.deviceId)},
+        });
+    }
 
-QPushButton[class="plainButton"] {
-    background-color: #112266;
-    color: white;
-    border: none;
-    padding: 10px 16px;
-    border-radius: 5px;
-    font-weight: bold;
-    font-size: 12px;
-}
-QPushButton[class="plainButton"]:hover {
-    background-color: #1a3cff;
-}
+    const auto &snapshot = InventorySnapshot::cached();
+    const QList<PackageIndex::Package> installed = snapshot && !snapshot->packagesStale()
+        ? snapshot->packages : PackageIndex::installed();
+
+    QJsonArray packages;
+    for (const auto &pkg : installed) {
+        packages.append(QJsonObject{
+            {"name", pkg.name},
+            {"version", pkg.version},
+            {"arch", pkg.arch},
+            {"installedKb", pkg.installedKb},
+        });
+    }
 
-QLineEdit, QTextEdit, QComboBox, QListWidget {
-    background-color: #111;
-    color: white;
-    border: 1px solid #223355;
-    padding: 5px;
-    border-radius: 4px;
+    return QJsonObject{
+        {"os", QJsonObject{{"name", info.osName}, {"pretty", info.osPretty}, {"kernel", info.kernel}}},
+        {"cpu", QJsonObject{
+            {"arch", info.cpuArch},
+            {"model", info.cpuModel},
+            {"vendor", HardwareDetector::cpuVendor()},
+            {"threads", info.cpuCores.toInt()},
+            {"packages", info.physicalCores.toInt()},
+        }},
+        {"gpu", QJsonObject{{"vendor", HardwareDetector::gpuVendor(gpus)}, {"devices", gpuList}}},
+        {"ram", info.ram},
+        {"storage", info.storage},
+        {"hostname", info.hostname},
+        {"uptime", info.uptime},
+        {"user", info.user},
+        {"installDate", info.installDate},
+        {"time", QDateTime::currentDateTime().toString(Qt::ISODate)},
+        {"packages", packages},
+        {"benchmark", snapshot && !snapshot->benchmarks.isEmpty() ? benchmarkJson(snapshot->benchmarks.last()) : QJsonObject()},
+    };
 }
 
-QGroupBox {
-    color: #ffffff;
-    font-weight: bold;
-    font-size: 13px;
-    margin-top: 12px;
-    padding-top: 12px;
-    border: 1px solid #1a3cff;
-    border-radius: 6px;
+int benchmark(const QStringList &args) {
+    QTextStream err(stderr);
+    const QList<Benchmark::Test> &tests = Benchmark::tests();
+    const auto run = Benchmark::run([&](int step) {
+        err << "[" << step + 1 << "/" << tests.size() << "] " << tests[step].name << "\n";
+        err.flush();
+        return true;
+    });
+
+    Benchmark::Run stored = *run;
+    InventorySnapshot::update([&stored](InventorySnapshot &snapshot) {
+        snapshot.addBenchmark(stored);
+        stored = snapshot.benchmarks.last();
+    });
+
+    QTextStream out(stdout);
+    if (args.contains("--json")) {
+        out << QJsonDocument(benchmarkJson(stored)).toJson(args.contains("--pretty") ? QJsonDocument::Indented : QJsonDocument::Compact);
+        if (!args.contains("--pretty")) out << "\n";
+        return 0;
+    }
+    for (const Benchmark::Test &test : tests) {
+        out << test.id << ": ";
+        if (run->scores.contains(test.id)) out << QString::number(run->scores.value(test.id), 'f', 2) << " " << test.unit << "\n";
+        else out << "n/a\n";
+    }
+    return 0;
 }
-QGroupBox::title {
-    left: 12px;
-    padding: 0 8px;
-    color: #00bfff;
+
+int daemon() {
+    const QString cacheDir = QFileInfo(InventorySnapshot::path()).absolutePath();
+    QDir().mkpath(cacheDir);
+    QLockFile lock(cacheDir + "/inventory.lock");
+    lock.setStaleLockTime(0);
+    if (!lock.tryLock(0)) {
+        QTextStream(stderr) << "err_: inventory daemon already running\n";
+        return 0;
+    }
+    InventoryDaemon inventoryDaemon;
+    return QCoreApplication::exec();
 }
 
+int run(const QStringList &args) {
+    if (args.contains("--daemon")) return daemon();
+    if (args.contains("--benchmark")) return benchmark(args);
 
+    QTextStream out(stdout);
+    const QJsonObject inv = inventory();
+    if (args.contains("--json")) {
+        out << QJsonDocument(inv).toJson(args.contains("--pretty") ? QJsonDocument::Indented : QJsonDocument::Compact);
+        if (!args.contains("--pretty")) out << "\n";
+        return 0;
+    }
 
-QScrollArea {
-    border: none;
-}
-QScrollBar:vertical {
-    width: 12px;
-    border-radius: 6px;
-}
-QScrollBar::handle:vertical {
-    background-color: #1a3cff;
-    border-radius: 6px;
-    min-height: 20px;
-}
-QScrollBar::handle:vertical:hover {
-    background-color: #00bfff;
-}
-QTabWidget::pane {
-    border: 1px solid #2a3245;
-    background-color: #0d0d0d;
-    border-radius: 6px;
-    padding: 4px;
-}
-QTabBar::tab {
-    background-color: #1a1a1a;
-    color: #9ca0b0;
-    padding: 8px 20px;
-    font-family: 'Nimbus Mono';
-    font-size: 11pt;
-    border-top-left-radius: 6px;
-    border-top-right-radius: 6px;
-    margin: 2px;
-}
-QTabBar::tab:selected {
-    background-color: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #3a86ff, stop:1 #001f54);
-    color: #ffffff;
-    font-weight: bold;
-    border: 1px solid #3a86ff;
-}
-QTabBar::tab:!selected:hover {
-    background-color: #2a3245;
-    color: #ffffff;
-    border: 1px solid #5a6fff;
-    font-weight: bold;
-}QTabWidget::pane {
-    border: 1px solid #2a3245;
-    background-color: #0d0d0d;
-    border-radius: 6px;
-    padding: 4px;
-}
-QTabBar::tab {
-    background-color: #1a1a1a;
-    color: #9ca0b0;
-    padding: 8px 20px;
-    font-family: 'Nimbus Mono';
-    font-size: 11pt;
-    border-top-left-radius: 6px;
-    border-top-right-radius: 6px;
-    margin: 2px;
-}
-QTabBar::tab:selected {
-    background-color: qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #3a86ff, stop:1 #001f54);
-    color: #ffffff;
-    font-weight: bold;
-    border: 1px solid #3a86ff;
+    for (auto it = inv.begin(); it != inv.end(); ++it) {
+        if (it.key() == "packages") {
+            out << "packages: " << it.value().toArray().size() << "\n";
+        } else if (it.value().isObject()) {
+            const QJsonObject sub = it.value().toObject();
+            for (auto s = sub.begin(); s != sub.end(); ++s)
+                if (!s.value().isArray() && !s.value().isObject())
+                    out << it.key() << "." << s.key() << ": " << s.value().toVariant().toString() << "\n";
+        } else {
+            out << it.key() << ": " << it.value().toVariant().toString() << "\n";
+        }
+    }
+    return 0;
 }
-QTabBar::tab:!selected:hover {
-    background-color: #2a3245;
-    color: #ffffff;
-    border: 1px solid #5a6fff;
-    font-weight: bold;
 }
-)");
+
+#include "err_.moc"
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0 || qstrcmp(argv[i], "--daemon") == 0 || qstrcmp(argv[i], "--benchmark") == 0) {
+            QCoreApplication core(argc, argv);
+            core.setApplicationName("err_");
+            core.setOrganizationName("error.os");
+            return Headless::run(core.arguments());
+        }
+    }
+
+    QStringList forwarded;
+    for (int i = 1; i < argc; ++i)
+        forwarded << QString::fromLocal8Bit(argv[i]);
+    // Set before any QApplication exists so the lock file records a name
+    // that matches the running process.
+    QCoreApplication::setApplicationName("err_");
+    QLockFile primaryLock(SingleInstance::socketPath() + ".lock");
+    if (!SingleInstance::claim(forwarded, primaryLock))
+        return 0;
+
+    QApplication app(argc, argv);
+    app.setApplicationName("err_");
+    app.setApplicationVersion("3.0");
+    app.setOrganizationName("error.os");
+
+    QFont mono("Nimbus Mono");
+    if (!mono.exactMatch()) mono = QFont("monospace");
+    mono.setStyleHint(QFont::Monospace);
+    app.setFont(mono);
+
+    app.setStyleSheet(Theme::styleSheet());
+
+    if (QSettings().value("inventory/daemon", false).toBool())
+        QProcess::startDetached(QCoreApplication::applicationFilePath(), {"--daemon"});
 
     MainWindow window;
-    window.show();
+    SingleInstance instance;
+    if (primaryLock.isLocked()) instance.listen();
+    QObject::connect(&instance, &SingleInstance::activated, &window, &MainWindow::activate);
+    window.activate(app.arguments());
 
     return app.exec();
 }